@@ -1,88 +1,62 @@
-// chess_ai_evaluation.h
+// chess_ai_evaluation.cpp
 // by Jake Charles Osborne III
 
 
 
 #include "chess_ai_evaluation.h"
 #include "../../MVC/Model/chess_model.h"
+#include "../../IO/chess_mapped_file.h"
 #include <string>
-#include <vecor>
-#include <optional>
-#include <unordered_map>
+#include <array>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <stdexcept>
 
 using namespace chess;
-using std::string;
-using std::vector;
-using std::optional;
-using std::unordered_map;
+using namespace chess::ai;
 
 
 namespace {
 
-    const unordered_map<string, double> HEURISTICS = parseHeuristics("heuristics.dat");
+    const std::size_t HEURISTIC_COUNT = static_cast<std::size_t>(evaluation::Heuristic::count);
 
-    unordered_map<string, double> parseHeuristics(string filename) {
-        std::ifstream heuristics_file("filename");
-        if (!heuristics_file.is_open()) throw std::runtime_error(filename + " not available");
+    constexpr std::array<double, HEURISTIC_COUNT> DEFAULT_HEURISTICS = {
+        -0.1 // doubledPawn
+    };
 
-        unordered_map<string, double> keyValuePairs;
+    const std::uint8_t HEURISTICS_FILE_TAG[4] = { 'C', 'C', 'H', 'W' };
 
-        string line;
-        while (std::getline(heuristics_file, line)) {
-            size_t pos = line.find('=');
+    std::array<double, HEURISTIC_COUNT> heuristics = DEFAULT_HEURISTICS;
 
-            if (pos != string::npos) {
-                string key = line.substr(0, pos);
-                double value = std::stod(line.substr(pos + 1));
-                keyValuePairs[key] = value;
-            }
-        }
-
-        heuristics_file.close();
-
-        return keyValuePairs;
+    std::uint64_t readLittleEndian(const std::uint8_t* bytes, int byteCount) {
+        std::uint64_t value = 0;
+        for (int i = byteCount - 1; i >= 0; --i) value = value << 8 | bytes[i];
+        return value;
     }
 
-    double pieceValues(
-        vector<std::tuple<char, model::Piece::Color, model::Piece::Position>> pieces,
-        Piece::Color aiColor
-    ) {
-        double boardValue = 0;
-
-        for (const auto& [notation, color, position] : pieces) {
-            auto pieceValueItr = HEURISTICS.find(std::string(1, notation));
-            if (pieceValueItr == HEURISTICS.end()) throw std::runtime_error("piece of type \'" + std::string(1, notation) + "\' not found");
-
-            if (color == aiColor) boardValue += pieceValueItr->second;
-            else boardValue -= pieceValueItr->second;
-        }
-
-        return boardValue;
+    // material and piece-square scores are kept by the board as it moves
+    double pieceValues(const model::Board& board, model::Piece::Color aiColor) {
+        return board.getPieceSquareScore(aiColor) / 100.0;
     }
 
-    double doubledPawnValue(
-        vector<std::tuple<char, model::Piece::Color, model::Piece::Position>> pieces,
-        Piece::Color aiColor
-    ) {
-        double boardValue = 0;
-
-        auto pieceValueItr = HEURISTICS.find("doubledPawn");
-        if (pieceValueItr == HEURISTICS.end()) throw std::runtime_error("doubledPawn value not found");
-
-
-        for (const auto& [notation, color, position] : pieces) {
-
-            if (color == aiColor) boardValue += pieceValueItr->second;
-            else boardValue -= pieceValueItr->second;
+    int countDoubledPawns(model::Bitboard pawns) {
+        const model::Bitboard FILE_A = 0x0101010101010101ULL;
+        int doubledPawns = 0;
+        for (int file = 0; file < 8; ++file) {
+            doubledPawns += std::max(0, std::popcount(pawns & (FILE_A << file)) - 1);
         }
+        return doubledPawns;
+    }
 
-        return boardValue;
+    double doubledPawnValue(const model::Board& board, model::Piece::Color aiColor) {
+        model::Piece::Color opponent = aiColor == model::Piece::Color::white ? model::Piece::Color::black : model::Piece::Color::white;
+        int doubledPawns = countDoubledPawns(board.getPieceBitboard(aiColor, model::Piece::Type::pawn)) -
+            countDoubledPawns(board.getPieceBitboard(opponent, model::Piece::Type::pawn));
+        return doubledPawns * heuristics[static_cast<std::size_t>(evaluation::Heuristic::doubledPawn)];
     }
 
-    double castlingAvailableValue(
-        vector<std::tuple<char, model::Piece::Color, model::Piece::Position>> pieces,
-        Piece::Color aiColor
-    ) {
+    double castlingAvailableValue(const model::Board& board, model::Piece::Color aiColor) {
         double boardValue = 0;
 
         // TODO: evaluate board
@@ -95,18 +69,31 @@ namespace {
 namespace chess::ai::evaluation {
 
 	double evaluate(const model::Board& board, const model::Piece::Color& maximizingPlayer) {
-        optional<model::Piece::Color> winner = board.getWinner();
-        if (winner && *winner == maximizingPlayer) return DBL_MAX;
-        if (winner && *winner != maximizingPlayer) return DBL_MIN;
-
-        auto pieces = board.getPieces();
-
         double boardValue = 0;
-        boardValue += pieceValues(pieces, maximizingPlayer);
-        boardValue += doubledPawnValue(pieces, maximizingPlayer);
-        boardValue += castlingAvailableValue(pieces, maximizingPlayer);
+        boardValue += pieceValues(board, maximizingPlayer);
+        boardValue += doubledPawnValue(board, maximizingPlayer);
+        boardValue += castlingAvailableValue(board, maximizingPlayer);
 
         return boardValue;
 	}
 
-}
\ No newline at end of file
+	double getHeuristic(Heuristic heuristic) {
+		return heuristics[static_cast<std::size_t>(heuristic)];
+	}
+
+	void loadHeuristics(const std::string& filename) {
+		io::MappedFile file(filename);
+		const std::uint8_t* data = file.getData();
+
+		if (file.getSize() < 8 || !std::equal(HEURISTICS_FILE_TAG, HEURISTICS_FILE_TAG + 4, data)) {
+			throw std::runtime_error(filename + " is not a heuristics file");
+		}
+		std::size_t count = std::size_t(readLittleEndian(data + 4, 4));
+		if (file.getSize() < 8 + count * 8) throw std::runtime_error(filename + " is truncated");
+
+		for (std::size_t i = 0; i < std::min(count, HEURISTIC_COUNT); ++i) {
+			heuristics[i] = std::bit_cast<double>(readLittleEndian(data + 8 + i * 8, 8));
+		}
+	}
+
+}
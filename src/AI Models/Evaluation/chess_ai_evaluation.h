@@ -1,14 +1,27 @@
 // chess_ai_evaluation.h
 // by Jake Charles Osborne III
+#pragma once
 
 
 
 #include "../../MVC/Model/chess_model.h"
 
+#include <string>
+
 
 
 namespace chess::ai::evaluation {
 
+	// evaluation weights, in pawns, addressed by index
+	enum class Heuristic { doubledPawn, count };
+
 	double evaluate(const chess::model::Board& board, const chess::model::Piece::Color& maximizingPlayer);
 
-}
\ No newline at end of file
+	double getHeuristic(Heuristic);
+
+	// replaces the compiled-in weights from a binary file: the bytes "CCHW", a little-endian uint32 count, then that
+	// many little-endian IEEE doubles in Heuristic order; weights past the count keep their defaults.
+	// not safe to call while a search is running. throws std::runtime_error for a missing or malformed file
+	void loadHeuristics(const std::string& filename);
+
+}
@@ -0,0 +1,245 @@
+// chess_ai_nnue.cpp
+// by Jake Charles Osborne III
+
+
+
+#include "chess_ai_nnue.h"
+#include "../../MVC/Model/chess_model.h"
+#include "../../IO/chess_mapped_file.h"
+
+#include <string>
+#include <memory>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <stdexcept>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace chess;
+using namespace chess::ai::evaluation::nnue;
+
+
+
+namespace {
+
+    // first-layer outputs are clipped to [0, ACTIVATION_RANGE]; output weights are scaled by OUTPUT_WEIGHT_SCALE and the
+    // output bias by both, so the raw output times OUTPUT_SCALE / (ACTIVATION_RANGE * OUTPUT_WEIGHT_SCALE) is in centipawns
+    const int ACTIVATION_RANGE = 255;
+    const int OUTPUT_WEIGHT_SCALE = 64;
+    const int OUTPUT_SCALE = 400;
+
+    const std::uint8_t NETWORK_FILE_TAG[4] = { 'C', 'C', 'N', 'N' };
+    const std::size_t NETWORK_FILE_SIZE = 8 + 2 * (INPUT_SIZE * HIDDEN_SIZE + HIDDEN_SIZE + 2 * HIDDEN_SIZE) + 4;
+
+    // most moves add one feature and remove one; a capture or castling adds one more change each way
+    const int MAX_FEATURE_CHANGES = 2;
+
+    struct Network
+    {
+        alignas(64) std::int16_t featureWeights[INPUT_SIZE][HIDDEN_SIZE];
+        alignas(64) std::int16_t featureBiases[HIDDEN_SIZE];
+        alignas(64) std::int16_t outputWeights[2][HIDDEN_SIZE];
+        std::int32_t outputBias;
+    };
+
+    std::unique_ptr<Network> network;
+
+    int indexOf(model::Piece::Color color) { return static_cast<int>(color); }
+
+    // inputs are relative to the perspective: its own pieces first, and black sees the board flipped
+    int featureIndex(model::Piece::Color perspective, model::Piece::Color color, model::Piece::Type type, int square) {
+        int relativeColor = color == perspective ? 0 : 1;
+        int relativeSquare = perspective == model::Piece::Color::white ? square : square ^ 56;
+        return (relativeColor * 6 + static_cast<int>(type)) * 64 + relativeSquare;
+    }
+
+    std::uint64_t readLittleEndian(const std::uint8_t* bytes, int byteCount) {
+        std::uint64_t value = 0;
+        for (int i = byteCount - 1; i >= 0; --i) value = value << 8 | bytes[i];
+        return value;
+    }
+
+    struct FeatureChanges
+    {
+        int added[MAX_FEATURE_CHANGES];
+        int removed[MAX_FEATURE_CHANGES];
+        int addedCount = 0;
+        int removedCount = 0;
+    };
+
+#if defined(__AVX2__)
+
+    void applyChanges(std::int16_t* values, const std::int16_t* parentValues, const FeatureChanges& changes) {
+        for (int i = 0; i < HIDDEN_SIZE; i += 16) {
+            __m256i sum = _mm256_load_si256(reinterpret_cast<const __m256i*>(parentValues + i));
+            for (int j = 0; j < changes.addedCount; ++j) {
+                sum = _mm256_add_epi16(sum, _mm256_load_si256(reinterpret_cast<const __m256i*>(network->featureWeights[changes.added[j]] + i)));
+            }
+            for (int j = 0; j < changes.removedCount; ++j) {
+                sum = _mm256_sub_epi16(sum, _mm256_load_si256(reinterpret_cast<const __m256i*>(network->featureWeights[changes.removed[j]] + i)));
+            }
+            _mm256_store_si256(reinterpret_cast<__m256i*>(values + i), sum);
+        }
+    }
+
+    std::int32_t clippedDot(const std::int16_t* values, const std::int16_t* weights) {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i range = _mm256_set1_epi16(ACTIVATION_RANGE);
+        __m256i sum = _mm256_setzero_si256();
+        for (int i = 0; i < HIDDEN_SIZE; i += 16) {
+            __m256i activation = _mm256_min_epi16(_mm256_max_epi16(_mm256_load_si256(reinterpret_cast<const __m256i*>(values + i)), zero), range);
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(activation, _mm256_load_si256(reinterpret_cast<const __m256i*>(weights + i))));
+        }
+        __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(half);
+    }
+
+#elif defined(__SSE2__)
+
+    void applyChanges(std::int16_t* values, const std::int16_t* parentValues, const FeatureChanges& changes) {
+        for (int i = 0; i < HIDDEN_SIZE; i += 8) {
+            __m128i sum = _mm_load_si128(reinterpret_cast<const __m128i*>(parentValues + i));
+            for (int j = 0; j < changes.addedCount; ++j) {
+                sum = _mm_add_epi16(sum, _mm_load_si128(reinterpret_cast<const __m128i*>(network->featureWeights[changes.added[j]] + i)));
+            }
+            for (int j = 0; j < changes.removedCount; ++j) {
+                sum = _mm_sub_epi16(sum, _mm_load_si128(reinterpret_cast<const __m128i*>(network->featureWeights[changes.removed[j]] + i)));
+            }
+            _mm_store_si128(reinterpret_cast<__m128i*>(values + i), sum);
+        }
+    }
+
+    std::int32_t clippedDot(const std::int16_t* values, const std::int16_t* weights) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i range = _mm_set1_epi16(ACTIVATION_RANGE);
+        __m128i sum = _mm_setzero_si128();
+        for (int i = 0; i < HIDDEN_SIZE; i += 8) {
+            __m128i activation = _mm_min_epi16(_mm_max_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(values + i)), zero), range);
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(activation, _mm_load_si128(reinterpret_cast<const __m128i*>(weights + i))));
+        }
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(sum);
+    }
+
+#else
+
+    void applyChanges(std::int16_t* values, const std::int16_t* parentValues, const FeatureChanges& changes) {
+        for (int i = 0; i < HIDDEN_SIZE; ++i) {
+            std::int16_t sum = parentValues[i];
+            for (int j = 0; j < changes.addedCount; ++j) sum += network->featureWeights[changes.added[j]][i];
+            for (int j = 0; j < changes.removedCount; ++j) sum -= network->featureWeights[changes.removed[j]][i];
+            values[i] = sum;
+        }
+    }
+
+    std::int32_t clippedDot(const std::int16_t* values, const std::int16_t* weights) {
+        std::int32_t sum = 0;
+        for (int i = 0; i < HIDDEN_SIZE; ++i) {
+            sum += std::clamp<std::int32_t>(values[i], 0, ACTIVATION_RANGE) * weights[i];
+        }
+        return sum;
+    }
+
+#endif
+
+}
+
+namespace chess::ai::evaluation::nnue {
+
+    void loadNetwork(const std::string& filename) {
+        io::MappedFile file(filename);
+        const std::uint8_t* data = file.getData();
+
+        if (file.getSize() < 8 || !std::equal(NETWORK_FILE_TAG, NETWORK_FILE_TAG + 4, data)) {
+            throw std::runtime_error(filename + " is not a network file");
+        }
+        if (readLittleEndian(data + 4, 4) != HIDDEN_SIZE) throw std::runtime_error(filename + " has the wrong layer size");
+        if (file.getSize() != NETWORK_FILE_SIZE) throw std::runtime_error(filename + " is the wrong size");
+
+        auto loadedNetwork = std::make_unique<Network>();
+        const std::uint8_t* next = data + 8;
+        auto readInt16 = [&next]() {
+            std::int16_t value = std::int16_t(readLittleEndian(next, 2));
+            next += 2;
+            return value;
+        };
+
+        for (auto& row : loadedNetwork->featureWeights) {
+            for (std::int16_t& weight : row) weight = readInt16();
+        }
+        for (std::int16_t& bias : loadedNetwork->featureBiases) bias = readInt16();
+        for (auto& side : loadedNetwork->outputWeights) {
+            for (std::int16_t& weight : side) weight = readInt16();
+        }
+        loadedNetwork->outputBias = std::int32_t(readLittleEndian(next, 4));
+
+        network = std::move(loadedNetwork);
+    }
+
+    bool isLoaded() {
+        return network != nullptr;
+    }
+
+    void refresh(Accumulator& accumulator, const model::Board& board) {
+        for (model::Piece::Color perspective : { model::Piece::Color::white, model::Piece::Color::black }) {
+            std::int16_t* values = accumulator.values[indexOf(perspective)];
+            std::copy(network->featureBiases, network->featureBiases + HIDDEN_SIZE, values);
+
+            for (model::Piece::Color color : { model::Piece::Color::white, model::Piece::Color::black }) {
+                for (int type = 0; type < 6; ++type) {
+                    model::Bitboard pieces = board.getPieceBitboard(color, static_cast<model::Piece::Type>(type));
+                    while (pieces) {
+                        FeatureChanges changes;
+                        changes.added[changes.addedCount++] = featureIndex(perspective, color, static_cast<model::Piece::Type>(type), std::countr_zero(pieces));
+                        applyChanges(values, values, changes);
+                        pieces &= pieces - 1;
+                    }
+                }
+            }
+        }
+    }
+
+    void update(Accumulator& accumulator, const Accumulator& parent, const model::Board& board, const model::Move& move, const model::Board::UndoRecord& undoRecord) {
+        model::Piece::Color mover = board.getCurrentTurn() == model::Piece::Color::white ? model::Piece::Color::black : model::Piece::Color::white;
+        int from = move.getFromSquare();
+        int to = move.getToSquare();
+        model::Piece::Type placedType = board.getPieceAt(to)->second;
+        model::Piece::Type movedType = move.isPromotion() ? model::Piece::Type::pawn : placedType;
+
+        for (model::Piece::Color perspective : { model::Piece::Color::white, model::Piece::Color::black }) {
+            FeatureChanges changes;
+            changes.removed[changes.removedCount++] = featureIndex(perspective, mover, movedType, from);
+            changes.added[changes.addedCount++] = featureIndex(perspective, mover, placedType, to);
+
+            if (move.isCapture()) {
+                int capturedSquare = move.getFlag() == model::Move::enPassantCapture ? (from & ~7) | (to & 7) : to;
+                model::Piece::Color capturedColor = static_cast<model::Piece::Color>(undoRecord.capturedPiece / 6);
+                model::Piece::Type capturedType = static_cast<model::Piece::Type>(undoRecord.capturedPiece % 6);
+                changes.removed[changes.removedCount++] = featureIndex(perspective, capturedColor, capturedType, capturedSquare);
+            }
+            else if (move.getFlag() == model::Move::kingsideCastle || move.getFlag() == model::Move::queensideCastle) {
+                bool kingside = move.getFlag() == model::Move::kingsideCastle;
+                changes.removed[changes.removedCount++] = featureIndex(perspective, mover, model::Piece::Type::rook, kingside ? from + 3 : from - 4);
+                changes.added[changes.addedCount++] = featureIndex(perspective, mover, model::Piece::Type::rook, kingside ? from + 1 : from - 1);
+            }
+
+            applyChanges(accumulator.values[indexOf(perspective)], parent.values[indexOf(perspective)], changes);
+        }
+    }
+
+    double evaluate(const Accumulator& accumulator, const model::Piece::Color& sideToMove) {
+        std::int64_t output = std::int64_t(clippedDot(accumulator.values[indexOf(sideToMove)], network->outputWeights[0])) +
+            clippedDot(accumulator.values[1 - indexOf(sideToMove)], network->outputWeights[1]) +
+            network->outputBias;
+        return double(output * OUTPUT_SCALE / (ACTIVATION_RANGE * OUTPUT_WEIGHT_SCALE)) / 100.0;
+    }
+
+}
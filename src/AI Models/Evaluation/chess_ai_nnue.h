@@ -0,0 +1,40 @@
+// chess_ai_nnue.h
+// by Jake Charles Osborne III
+#pragma once
+
+
+
+#include "../../MVC/Model/chess_model.h"
+
+#include <string>
+#include <cstdint>
+
+
+
+// a small quantised network: 768 piece-square inputs seen from each side, a 128-wide first layer shared by both
+// sides, clipped ReLU, and one output. the first layer is kept as an accumulator updated move by move
+namespace chess::ai::evaluation::nnue {
+
+	constexpr int INPUT_SIZE = 768;
+	constexpr int HIDDEN_SIZE = 128;
+
+	// first-layer sums from white's side and from black's side
+	struct alignas(64) Accumulator
+	{
+		std::int16_t values[2][HIDDEN_SIZE];
+	};
+
+	// weights file: the bytes "CCNN", a little-endian uint32 hidden size that must equal HIDDEN_SIZE, then
+	// little-endian int16 feature weights [INPUT_SIZE][HIDDEN_SIZE], int16 feature biases [HIDDEN_SIZE],
+	// int16 output weights [2 * HIDDEN_SIZE] (side to move first) and an int32 output bias.
+	// not safe to call while a search is running. throws std::runtime_error for a missing or malformed file
+	void loadNetwork(const std::string& filename);
+	bool isLoaded();
+
+	void refresh(Accumulator&, const chess::model::Board&);
+	// brings a parent position's accumulator up to date with a move that has just been made on board
+	void update(Accumulator&, const Accumulator& parent, const chess::model::Board& board, const chess::model::Move&, const chess::model::Board::UndoRecord&);
+
+	double evaluate(const Accumulator&, const chess::model::Piece::Color& sideToMove); // in pawns, like evaluation::evaluate
+
+}
@@ -0,0 +1,88 @@
+// chess_ai_static_exchange.cpp
+// by Jake Charles Osborne III
+
+
+
+#include "chess_ai_static_exchange.h"
+#include "../../MVC/Model/chess_model.h"
+#include <algorithm>
+
+using namespace chess;
+
+
+
+namespace {
+
+    // pawn, knight, bishop, rook, queen, king; the king is only ever the last piece to recapture
+    const int EXCHANGE_VALUES[6] = { 100, 300, 300, 500, 900, 20000 };
+
+    // a capture can take at most one piece per attacker, plus the first
+    const int MAX_EXCHANGES = 32;
+
+    int valueOf(model::Piece::Type type) { return EXCHANGE_VALUES[static_cast<int>(type)]; }
+
+    model::Piece::Color opponentOf(model::Piece::Color color) {
+        return color == model::Piece::Color::white ? model::Piece::Color::black : model::Piece::Color::white;
+    }
+
+}
+
+namespace chess::ai::evaluation {
+
+    int staticExchange(const model::Board& board, const model::Move& move) {
+        int from = move.getFromSquare();
+        int to = move.getToSquare();
+        model::Bitboard occupied = board.getColorBitboard(model::Piece::Color::white) | board.getColorBitboard(model::Piece::Color::black);
+
+        // gains[i] is what the side making capture i has won so far if the exchange stops there
+        int gains[MAX_EXCHANGES];
+        model::Piece::Type pieceOnSquare = board.getPieceAt(from)->second;
+        if (move.getFlag() == model::Move::enPassantCapture) {
+            gains[0] = valueOf(model::Piece::Type::pawn);
+            occupied ^= model::Bitboard(1) << ((from & ~7) | (to & 7));
+        }
+        else {
+            gains[0] = move.isCapture() ? valueOf(board.getPieceAt(to)->second) : 0;
+        }
+        if (move.isPromotion()) {
+            pieceOnSquare = *move.getPromotionType();
+            gains[0] += valueOf(pieceOnSquare) - valueOf(model::Piece::Type::pawn);
+        }
+        occupied ^= model::Bitboard(1) << from;
+
+        model::Piece::Color side = opponentOf(board.getCurrentTurn());
+        model::Bitboard attackers = board.getAttackersOf(to, occupied) & occupied;
+        int exchangeCount = 1;
+        while (exchangeCount < MAX_EXCHANGES) {
+            model::Bitboard sideAttackers = attackers & board.getColorBitboard(side);
+            if (!sideAttackers) break;
+
+            int type = 0;
+            model::Bitboard attacker = 0;
+            for (; type < 6; ++type) {
+                attacker = sideAttackers & board.getPieceBitboard(side, static_cast<model::Piece::Type>(type));
+                if (attacker) break;
+            }
+            attacker &= -attacker;
+
+            // a king can only take last, when nothing is left to take it back
+            if (type == static_cast<int>(model::Piece::Type::king) && (attackers & ~attacker & board.getColorBitboard(opponentOf(side)))) break;
+
+            gains[exchangeCount] = valueOf(pieceOnSquare) - gains[exchangeCount - 1];
+            ++exchangeCount;
+
+            // removing the attacker can uncover a slider behind it
+            occupied ^= attacker;
+            attackers = board.getAttackersOf(to, occupied) & occupied;
+            pieceOnSquare = static_cast<model::Piece::Type>(type);
+            side = opponentOf(side);
+        }
+
+        // walk back from the last capture: each side only takes when it does better than stopping
+        while (--exchangeCount > 0) {
+            gains[exchangeCount - 1] = -std::max(-gains[exchangeCount - 1], gains[exchangeCount]);
+        }
+        return gains[0];
+    }
+
+}
@@ -0,0 +1,17 @@
+// chess_ai_static_exchange.h
+// by Jake Charles Osborne III
+#pragma once
+
+
+
+#include "../../MVC/Model/chess_model.h"
+
+
+
+namespace chess::ai::evaluation {
+
+	// material won by the side making move once both sides have recaptured on its square with their least valuable
+	// attackers, each stopping when going on would lose more; in centipawns, negative for a losing capture
+	int staticExchange(const chess::model::Board&, const chess::model::Move&);
+
+}
@@ -0,0 +1,103 @@
+// chess_ai_opening_book.cpp
+// by Jake Charles Osborne III
+
+
+
+#include "chess_ai_opening_book.h"
+#include "../../MVC/Model/chess_model.h"
+#include "../../IO/chess_mapped_file.h"
+
+#include <string>
+#include <vector>
+#include <optional>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace chess;
+using namespace chess::ai;
+using std::vector;
+using std::optional;
+using std::nullopt;
+
+
+
+namespace {
+
+    const std::size_t ENTRY_SIZE = 16;
+
+    std::uint64_t readBigEndian(const std::uint8_t* bytes, int byteCount) {
+        std::uint64_t value = 0;
+        for (int i = 0; i < byteCount; ++i) value = value << 8 | bytes[i];
+        return value;
+    }
+
+    // to square in bits 0-5, from square in bits 6-11 and the promotion piece (knight = 1 through queen = 4) in bits
+    // 12-14; castling is written as the king taking its own rook
+    std::uint16_t toBookMove(const model::Move& move) {
+        int from = move.getFromSquare();
+        int to = move.getToSquare();
+        if (move.getFlag() == model::Move::kingsideCastle) to = from + 3;
+        else if (move.getFlag() == model::Move::queensideCastle) to = from - 4;
+        int promotion = move.isPromotion() ? static_cast<int>(*move.getPromotionType()) : 0;
+        return std::uint16_t(to | from << 6 | promotion << 12);
+    }
+
+}
+
+namespace chess::ai {
+
+    OpeningBook::OpeningBook(const std::string& filename) : file(filename), entryCount(file.getSize() / ENTRY_SIZE) {
+        if (file.getSize() % ENTRY_SIZE != 0) throw std::runtime_error(filename + " is not an opening book");
+    }
+
+    std::uint64_t OpeningBook::getKey(std::size_t entry) const {
+        return readBigEndian(file.getData() + entry * ENTRY_SIZE, 8);
+    }
+
+    vector<OpeningBook::Entry> OpeningBook::getEntries(const model::Board& board) const {
+        std::uint64_t key = board.getHashKey();
+        std::size_t first = 0;
+        std::size_t count = entryCount;
+        while (count > 0) {
+            std::size_t step = count / 2;
+            if (getKey(first + step) < key) {
+                first += step + 1;
+                count -= step + 1;
+            }
+            else {
+                count = step;
+            }
+        }
+
+        vector<Entry> entries;
+        auto availableMoves = board.getAvailableMoves();
+        for (std::size_t i = first; i < entryCount && getKey(i) == key; ++i) {
+            const std::uint8_t* entry = file.getData() + i * ENTRY_SIZE;
+            std::uint16_t bookMove = std::uint16_t(readBigEndian(entry + 8, 2));
+            auto moveItr = std::find_if(availableMoves.begin(), availableMoves.end(),
+                [bookMove](const model::Move& move) { return toBookMove(move) == bookMove; });
+            if (moveItr != availableMoves.end()) entries.push_back({ *moveItr, std::uint16_t(readBigEndian(entry + 10, 2)) });
+        }
+        return entries;
+    }
+
+    optional<int> OpeningBook::getMove(const model::Board& board) const {
+        vector<Entry> entries = getEntries(board);
+        std::uint32_t totalWeight = 0;
+        for (const Entry& entry : entries) totalWeight += entry.weight;
+        if (totalWeight == 0) return nullopt;
+
+        thread_local std::mt19937 generator(std::random_device{}());
+        std::uint32_t choice = std::uniform_int_distribution<std::uint32_t>(0, totalWeight - 1)(generator);
+        auto entryItr = entries.begin();
+        while (choice >= entryItr->weight) {
+            choice -= entryItr->weight;
+            ++entryItr;
+        }
+
+        auto availableMoves = board.getAvailableMoves();
+        return int(std::find(availableMoves.begin(), availableMoves.end(), entryItr->move) - availableMoves.begin());
+    }
+
+}
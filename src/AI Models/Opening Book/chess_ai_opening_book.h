@@ -0,0 +1,45 @@
+// chess_ai_opening_book.h
+// by Jake Charles Osborne III
+#pragma once
+
+
+
+#include "../../MVC/Model/chess_model.h"
+#include "../../IO/chess_mapped_file.h"
+
+#include <string>
+#include <vector>
+#include <optional>
+#include <cstdint>
+#include <cstddef>
+
+
+
+namespace chess::ai {
+
+	// a book in the Polyglot .bin layout: 16-byte big-endian entries of key, move, weight and learn data, sorted by key.
+	// keys are Board::getHashKey(), which is Polyglot's own, so any standard .bin book can be read
+	class OpeningBook
+	{
+	public:
+
+		struct Entry {
+			chess::model::Move move;
+			std::uint16_t weight;
+		};
+
+		explicit OpeningBook(const std::string& filename); // throws std::runtime_error for a missing or malformed file
+
+		std::vector<Entry> getEntries(const chess::model::Board&) const; // legal book moves only
+		// chosen at random in proportion to weight, as an index into board.getAvailableMoves()
+		std::optional<int> getMove(const chess::model::Board& board) const;
+
+	private:
+
+		chess::io::MappedFile file;
+		std::size_t entryCount;
+
+		std::uint64_t getKey(std::size_t entry) const;
+	};
+
+}
@@ -6,139 +6,427 @@
 #include "chess_ai_minimax.h"
 #include "../../../MVC/Model/chess_model.h"
 #include "../../Evaluation/chess_ai_evaluation.h"
-#include <string>
+#include "../../Evaluation/chess_ai_nnue.h"
+#include "../../Evaluation/chess_ai_static_exchange.h"
+#include "chess_ai_transposition_table.h"
+#include "../../chess_ai_time_manager.h"
 #include <vector>
-#include <unordered_map>
-#include <fstream>
-#include <random>
+#include <array>
+#include <future>
+#include <numeric>
+#include <memory>
+#include <atomic>
+#include <algorithm>
+#include <optional>
+#include <cfloat>
+#include <cmath>
 
 using namespace chess;
-using std::string;
+using namespace chess::ai;
 using std::vector;
-using std::unordered_map;
-using std::random_device;
-using std::mt19937;
-using std::uniform_int_distribution;
+using std::future;
 
 
 
 namespace {
 
-    struct MinimaxResult {
-        int moveIndex;
-        double moveScore;
+    const double CHECKMATE_SCORE = 100000;
+    const double CHECKMATE_THRESHOLD = CHECKMATE_SCORE - 1000;
+    const std::size_t DEFAULT_TRANSPOSITION_TABLE_MEGABYTES = 16;
+    const int MAX_PLY = 128;
+    // how many nodes a thread searches between looks at the clock and the shared node count; a power of two
+    const std::uint64_t STOP_CHECK_INTERVAL = 1024;
+
+    // move ordering bands, best first: the hash move, captures and promotions by MVV-LVA, the two killers, then
+    // quiet moves by history, which is halved whenever an entry reaches HISTORY_LIMIT so it stays below the killers
+    const int HASH_MOVE_SCORE = 1 << 30;
+    const int TACTICAL_MOVE_SCORE = 1 << 29;
+    const int KILLER_MOVE_SCORE = 1 << 28;
+    const int HISTORY_LIMIT = 1 << 20;
+
+    // one per search thread: a board walked in place with makeMove/unmakeMove, plus one reusable move list, ordering
+    // score list, pair of killer moves and network accumulator per ply. too large for a thread's stack, so it is only
+    // ever built in place on the heap
+    struct SearchState {
+        SearchState(const model::Board& board, std::atomic<bool>* stop, std::atomic<std::uint64_t>* sharedNodes, const TimeManager* timeManager,
+            TranspositionTable* transpositionTable) :
+            board(board), stop(stop), sharedNodes(sharedNodes), timeManager(timeManager), transpositionTable(transpositionTable) {}
+
+        model::Board board;
+        std::atomic<bool>* stop; // shared by every thread searching the same root
+        std::atomic<std::uint64_t>* sharedNodes; // every thread's nodes, in whole STOP_CHECK_INTERVALs
+        const TimeManager* timeManager;
+        TranspositionTable* transpositionTable; // shared by every thread searching the same root
+        std::uint64_t nodes = 0;
+        std::array<vector<model::Move>, MAX_PLY> moveLists = {};
+        std::array<vector<int>, MAX_PLY> moveScores = {};
+        std::array<std::array<model::Move, 2>, MAX_PLY> killerMoves = {};
+        int history[2][64][64] = {}; // quiet moves by side, from square and to square that caused a cutoff
+        std::array<evaluation::nnue::Accumulator, MAX_PLY> accumulators = {};
     };
 
-    MinimaxResult minimize(const model::Board& board, const model::Piece::Color& maximizingPlayer, int depth) {
-        MinimaxResult bestResult = { -1, DBL_MAX };
+    // most valuable victim first, then least valuable attacker; a promotion counts its new piece as the victim
+    int scoreTacticalMove(const model::Board& board, const model::Move& move) {
+        int attacker = static_cast<int>(board.getPieceAt(move.getFromSquare())->second);
+        int victim = 0;
+        if (move.getFlag() == model::Move::enPassantCapture) victim = static_cast<int>(model::Piece::Type::pawn);
+        else if (move.isCapture()) victim = static_cast<int>(board.getPieceAt(move.getToSquare())->second);
+        if (move.isPromotion()) victim += static_cast<int>(*move.getPromotionType());
+        return TACTICAL_MOVE_SCORE + victim * 8 - attacker;
+    }
 
-        auto availableMoves = board.getAvailableMoves();
-        for (int i = 0; i < availableMoves.size(); i++) {
-            model::Board nextBoard = board;
-            nextBoard.addPiece(i);
+    void scoreMoves(const SearchState& state, const vector<model::Move>& moves, vector<int>& scores, std::uint16_t hashMove, int ply) {
+        const model::Board& board = state.board;
+        int side = static_cast<int>(board.getCurrentTurn());
+        scores.resize(moves.size());
+        for (std::size_t i = 0; i < moves.size(); i++) {
+            const model::Move& move = moves[i];
+            if (move.getEncoding() == hashMove) scores[i] = HASH_MOVE_SCORE;
+            else if (move.isCapture() || move.isPromotion()) scores[i] = scoreTacticalMove(board, move);
+            else if (move == state.killerMoves[ply][0]) scores[i] = KILLER_MOVE_SCORE + 1;
+            else if (move == state.killerMoves[ply][1]) scores[i] = KILLER_MOVE_SCORE;
+            else scores[i] = state.history[side][move.getFromSquare()][move.getToSquare()];
+        }
+    }
 
-            double score = minimax(board, maximizingPlayer, depth - 1).moveScore;
+    // selection sort one move at a time, since a cutoff usually comes before the list is exhausted
+    void pickNextMove(vector<model::Move>& moves, vector<int>& scores, std::size_t index) {
+        std::size_t bestIndex = index;
+        for (std::size_t i = index + 1; i < moves.size(); i++) {
+            if (scores[i] > scores[bestIndex]) bestIndex = i;
+        }
+        std::swap(moves[index], moves[bestIndex]);
+        std::swap(scores[index], scores[bestIndex]);
+    }
 
-            if (score < bestResult.moveScore) {
-                bestResult = { i, score };
+    void recordQuietCutoff(SearchState& state, const model::Move& move, int depth, int ply) {
+        std::array<model::Move, 2>& killers = state.killerMoves[ply];
+        if (!(move == killers[0])) {
+            killers[1] = killers[0];
+            killers[0] = move;
+        }
+
+        auto& sideHistory = state.history[static_cast<int>(state.board.getCurrentTurn())];
+        int& entry = sideHistory[move.getFromSquare()][move.getToSquare()];
+        entry += depth * depth;
+        if (entry >= HISTORY_LIMIT) {
+            for (auto& fromSquare : sideHistory) {
+                for (int& value : fromSquare) value /= 2;
             }
         }
+    }
 
-        return bestResult;
+    bool shouldStop(SearchState& state) {
+        if ((state.nodes & (STOP_CHECK_INTERVAL - 1)) == 0) {
+            std::uint64_t totalNodes = state.sharedNodes->fetch_add(STOP_CHECK_INTERVAL, std::memory_order_relaxed) + STOP_CHECK_INTERVAL;
+            if (state.timeManager->isHardLimitReached(totalNodes)) state.stop->store(true, std::memory_order_relaxed);
+        }
+        return state.stop->load(std::memory_order_relaxed);
     }
 
-    MinimaxResult maximize(const model::Board& board, const model::Piece::Color& maximizingPlayer, int depth) {
-        MinimaxResult bestResult = { -1, DBL_MIN };
+    // the accumulator for ply + 1 is built from the one for ply, so the network never sees the whole board again
+    model::Board::UndoRecord makeSearchMove(SearchState& state, const model::Move& move, int ply) {
+        model::Board::UndoRecord undoRecord = state.board.makeMove(move);
+        if (evaluation::nnue::isLoaded()) {
+            evaluation::nnue::update(state.accumulators[ply + 1], state.accumulators[ply], state.board, move, undoRecord);
+        }
+        return undoRecord;
+    }
 
-        auto availableMoves = board.getAvailableMoves();
-        for (int i = 0; i < availableMoves; i++) {
-            model::Board nextBoard = board;
-            nextBoard.makeMove(i);
+    double evaluateLeaf(const SearchState& state, int ply) {
+        if (evaluation::nnue::isLoaded()) return evaluation::nnue::evaluate(state.accumulators[ply], state.board.getCurrentTurn());
+        return evaluation::evaluate(state.board, state.board.getCurrentTurn());
+    }
 
-            double score = minimax(board, maximizingPlayer, depth - 1).moveScore;
+    // insufficient material is a draw, whatever the evaluation makes of the pieces left
+    std::optional<double> getEndgameScore(const model::Board& board) {
+        if (board.hasInsufficientMaterial()) return 0;
+        return std::nullopt;
+    }
 
-            if (score > bestResult.moveScore) {
-                bestResult = { i, score };
+    // mate scores are stored relative to the node so they stay correct when reached at another ply
+    double toTranspositionScore(double score, int ply) {
+        if (score > CHECKMATE_THRESHOLD) return score + ply;
+        if (score < -CHECKMATE_THRESHOLD) return score - ply;
+        return score;
+    }
+
+    double fromTranspositionScore(double score, int ply) {
+        if (score > CHECKMATE_THRESHOLD) return score - ply;
+        if (score < -CHECKMATE_THRESHOLD) return score + ply;
+        return score;
+    }
+
+    // captures and promotions only, until the position is quiet, so the evaluation is never taken halfway through an
+    // exchange. the side to move may stand pat on the static score, except in check, where every evasion is tried.
+    // captures the static exchange evaluator calls losing are skipped
+    double quiescence(SearchState& state, double alpha, double beta, int ply) {
+        model::Board& board = state.board;
+        ++state.nodes;
+        if (shouldStop(state)) return 0;
+        if (auto endgameScore = getEndgameScore(board)) return *endgameScore;
+
+        bool inCheck = board.pieceToCaptureInCheck(board.getCurrentTurn());
+        double bestScore = -DBL_MAX;
+        if (!inCheck) {
+            bestScore = evaluateLeaf(state, ply);
+            if (bestScore >= beta || ply >= MAX_PLY - 1) return bestScore;
+            alpha = std::max(alpha, bestScore);
+        }
+        else if (ply >= MAX_PLY - 1) {
+            return evaluateLeaf(state, ply);
+        }
+
+        vector<model::Move>& availableMoves = state.moveLists[ply];
+        board.getAvailableMoves(availableMoves);
+        if (availableMoves.empty()) {
+            return inCheck ? -(CHECKMATE_SCORE - ply) : 0;
+        }
+
+        vector<int>& moveScores = state.moveScores[ply];
+        scoreMoves(state, availableMoves, moveScores, 0, ply);
+
+        for (std::size_t i = 0; i < availableMoves.size(); i++) {
+            pickNextMove(availableMoves, moveScores, i);
+            const model::Move& move = availableMoves[i];
+            if (!inCheck) {
+                if (moveScores[i] < TACTICAL_MOVE_SCORE) break; // only quiet moves are left
+                if (evaluation::staticExchange(board, move) < 0) continue;
             }
+
+            model::Board::UndoRecord undoRecord = makeSearchMove(state, move, ply);
+            double score = -quiescence(state, -beta, -alpha, ply + 1);
+            board.unmakeMove(move, undoRecord);
+
+            bestScore = std::max(bestScore, score);
+            alpha = std::max(alpha, score);
+            if (alpha >= beta) break;
         }
 
-        return bestResult;
+        return bestScore;
     }
 
-    MinimaxResult multithreadingMinimize(const model::Board& board, const model::Piece::Color& maximizingPlayer, int depth) {
-        MinimaxResult bestResult = { -1, DBL_MAX };
+    // scores are from the side to move's point of view
+    double negamax(SearchState& state, int depth, double alpha, double beta, int ply) {
+        if (depth == 0) return quiescence(state, alpha, beta, ply);
+
+        model::Board& board = state.board;
+        ++state.nodes;
+        if (shouldStop(state)) return 0;
+        if (ply >= MAX_PLY - 1) return evaluateLeaf(state, ply);
+        if (auto endgameScore = getEndgameScore(board)) return *endgameScore;
+
+        double originalAlpha = alpha;
+        std::uint64_t key = board.getHashKey();
+        std::uint16_t hashMove = 0;
+        if (auto hit = state.transpositionTable->probe(key)) {
+            hashMove = hit->bestMove;
+            if (hit->depth >= depth) {
+                double score = fromTranspositionScore(hit->score, ply);
+                if (hit->bound == TranspositionTable::Bound::exact) return score;
+                if (hit->bound == TranspositionTable::Bound::lower) alpha = std::max(alpha, score);
+                if (hit->bound == TranspositionTable::Bound::upper) beta = std::min(beta, score);
+                if (alpha >= beta) return score;
+            }
+        }
 
-        auto availableMoves = board.getAvailableMoves();
-        auto* optFutures = new future<MinimaxResult>[availableMoves.size()];
-        for (int i = 0; i < availableMoves.size(); i++) {
-            model::Board nextBoard = board;
-            nextBoard.makeMove(i);
-            optFutures[i] = async(std::launch::async,
-                minimax, board, maximizingPlayer, depth - 1);
+        vector<model::Move>& availableMoves = state.moveLists[ply];
+        board.getAvailableMoves(availableMoves);
+        if (availableMoves.empty()) {
+            return board.pieceToCaptureInCheck(board.getCurrentTurn()) ? -(CHECKMATE_SCORE - ply) : 0;
         }
-        for (int i = 0; i < availableMoves.size(); i) {
-            MinimaxResult minimaxResult = optFutures[i]->get();
-            if (minimaxResult.moveScore < bestResult.moveScore) {
-                bestResult = { i, minimaxResult.moveScore };
+
+        vector<int>& moveScores = state.moveScores[ply];
+        scoreMoves(state, availableMoves, moveScores, hashMove, ply);
+
+        double bestScore = -DBL_MAX;
+        std::size_t bestIndex = 0;
+        for (std::size_t i = 0; i < availableMoves.size(); i++) {
+            pickNextMove(availableMoves, moveScores, i);
+            model::Board::UndoRecord undoRecord = makeSearchMove(state, availableMoves[i], ply);
+            double score = -negamax(state, depth - 1, -beta, -alpha, ply + 1);
+            board.unmakeMove(availableMoves[i], undoRecord);
+
+            if (score > bestScore) {
+                bestScore = score;
+                bestIndex = i;
+            }
+            alpha = std::max(alpha, score);
+            if (alpha >= beta) {
+                if (!availableMoves[i].isCapture() && !availableMoves[i].isPromotion()) recordQuietCutoff(state, availableMoves[i], depth, ply);
+                break;
             }
         }
-        delete optFutures;
+        if (state.stop->load(std::memory_order_relaxed)) return 0;
 
-        return bestResult;
+        TranspositionTable::Bound bound = TranspositionTable::Bound::exact;
+        if (bestScore <= originalAlpha) bound = TranspositionTable::Bound::upper;
+        else if (bestScore >= beta) bound = TranspositionTable::Bound::lower;
+        state.transpositionTable->store(key, depth, bound, toTranspositionScore(bestScore, ply), availableMoves[bestIndex].getEncoding());
+
+        return bestScore;
     }
 
-    MinimaxResult multithreadingMaximize(const model::Board board&, const model::Piece::Color& maximizingPlayer, int depth) {
-        MinimaxResult bestResult = { -1, DBL_MIN };
+    double searchRootMove(SearchState& state, const model::Move& move, int depth, double alpha, double beta) {
+        model::Board::UndoRecord undoRecord = makeSearchMove(state, move, 0);
+        double score = -negamax(state, depth - 1, -beta, -alpha, 1);
+        state.board.unmakeMove(move, undoRecord);
+        return score;
+    }
 
-        auto availableMoves = board.getAvailableMoves();
-        auto* optFutures = new future<MinimaxResult>[availableMoves.size()];
-        for (int i = 0; i < availableMoves.size(); i++) {
-            model::Board nextBoard = board;
-            nextBoard.makeMove(i);
-            optFutures[i] = async(std::launch::async,
-                minimax, board, maximizingPlayer, depth - 1);
+    // the table may hold a stale or colliding move, so each one is checked before it is played; the walk stops after
+    // maxLength moves, which also ends it in a repetition
+    vector<model::Move> getPrincipalVariation(model::Board board, const TranspositionTable& transpositionTable, const model::Move& rootMove, std::size_t maxLength) {
+        vector<model::Move> principalVariation = { rootMove };
+        board.makeMove(rootMove);
+        while (principalVariation.size() < maxLength) {
+            auto hit = transpositionTable.probe(board.getHashKey());
+            if (!hit || !hit->bestMove) break;
+            model::Move move(hit->bestMove);
+            auto availableMoves = board.getAvailableMoves();
+            if (std::find(availableMoves.begin(), availableMoves.end(), move) == availableMoves.end()) break;
+            board.makeMove(move);
+            principalVariation.push_back(move);
         }
-        for (int i = 0; i < availableMoves.size(); i) {
-            MinimaxResult minimaxResult = optFutures[i]->get();
-            if (minimaxResult.moveScore > bestResult.moveScore) {
-                bestResult = { i, minimaxResult.moveScore };
+        return principalVariation;
+    }
+
+    SearchInfo getSearchInfo(const SearchState& state, const vector<model::Move>& rootMoves, const MinimaxResult& result, int depth) {
+        std::optional<int> mateIn;
+        if (std::abs(result.moveScore) > CHECKMATE_THRESHOLD) {
+            int plies = int(std::lround(CHECKMATE_SCORE - std::abs(result.moveScore)));
+            mateIn = result.moveScore > 0 ? plies : -plies;
+        }
+        return {
+            depth,
+            result.moveScore,
+            mateIn,
+            state.sharedNodes->load(std::memory_order_relaxed) + state.nodes % STOP_CHECK_INTERVAL,
+            state.timeManager->getElapsed(),
+            getPrincipalVariation(state.board, *state.transpositionTable, rootMoves[result.moveIndex], depth)
+        };
+    }
+
+    // rootOrder lists indices into rootMoves, best candidate first
+    MinimaxResult searchRoot(SearchState& state, const vector<model::Move>& rootMoves, const vector<int>& rootOrder, int depth) {
+        MinimaxResult bestResult = { -1, -DBL_MAX, 0 };
+        double alpha = -DBL_MAX;
+
+        for (int i : rootOrder) {
+            double score = searchRootMove(state, rootMoves[i], depth, alpha, DBL_MAX);
+            if (score > bestResult.moveScore) {
+                bestResult = { i, score };
+                alpha = score;
             }
         }
-        delete optFutures;
 
         return bestResult;
     }
 
-}
+    // Lazy SMP: every thread deepens the same root on its own board, sharing only the transposition table and the
+    // stop flag. Helpers start one ply deeper on odd threads so they fill the table ahead of the main thread.
+    // the main thread alone decides when to stop between iterations; any thread can stop them all at a hard limit
+    MinimaxResult iterativeDeepening(const model::Board& board, const model::Piece::Color& maximizingPlayer, const SearchLimits& limits, int threadCount,
+        TranspositionTable& transpositionTable, const SearchInfoCallback& onIteration) {
+        std::atomic<bool> stop = false;
+        std::atomic<std::uint64_t> sharedNodes = 0;
+        TimeManager timeManager(limits, board.getCurrentTurn());
+        int maxDepth = std::clamp(limits.maxDepth, 0, MAX_PLY - 1);
+        double perspective = maximizingPlayer == board.getCurrentTurn() ? 1 : -1;
+
+        if (maxDepth == 0) {
+            if (!evaluation::nnue::isLoaded()) return { -1, perspective * evaluation::evaluate(board, board.getCurrentTurn()), 1 };
+            evaluation::nnue::Accumulator accumulator;
+            evaluation::nnue::refresh(accumulator, board);
+            return { -1, perspective * evaluation::nnue::evaluate(accumulator, board.getCurrentTurn()), 1 };
+        }
 
-namespace chess::ai {
+        auto rootMoves = board.getAvailableMoves();
+        if (rootMoves.empty()) {
+            double score = board.pieceToCaptureInCheck(board.getCurrentTurn()) ? -CHECKMATE_SCORE : 0;
+            return { -1, perspective * score, 1 };
+        }
 
-    MinimaxResult minimax(const model::Board& board, const model::Piece::Color& maximizingPlayer, const int& depth) {
-        if (depth == 0) return { -1, evaluateBoard(board, maximizingPlayer) };
+        auto searchThread = [&board, &rootMoves, &stop, &sharedNodes, &timeManager, &transpositionTable, &onIteration, maxDepth](int threadIndex) {
+            auto state = std::make_unique<SearchState>(board, &stop, &sharedNodes, &timeManager, &transpositionTable);
+            if (evaluation::nnue::isLoaded()) evaluation::nnue::refresh(state->accumulators[0], state->board);
+
+            vector<int>& rootScores = state->moveScores[0];
+            scoreMoves(*state, rootMoves, rootScores, 0, 0);
+            vector<int> rootOrder(rootMoves.size());
+            std::iota(rootOrder.begin(), rootOrder.end(), 0);
+            std::stable_sort(rootOrder.begin(), rootOrder.end(), [&rootScores](int a, int b) { return rootScores[a] > rootScores[b]; });
+
+            MinimaxResult bestResult = { -1, -DBL_MAX, 0 };
+            std::uint64_t previousIterationNodes = 0;
+            double effectiveBranchingFactor = 0;
+            for (int depth = 1 + threadIndex % 2; depth <= maxDepth && !stop; depth++) {
+                std::uint64_t nodesBefore = state->nodes;
+                MinimaxResult result = searchRoot(*state, rootMoves, rootOrder, depth);
+                if (stop) break;
+                bestResult = result;
+
+                std::uint64_t iterationNodes = state->nodes - nodesBefore;
+                if (previousIterationNodes) effectiveBranchingFactor = double(iterationNodes) / previousIterationNodes;
+                previousIterationNodes = iterationNodes;
+
+                auto bestItr = std::find(rootOrder.begin(), rootOrder.end(), bestResult.moveIndex);
+                std::rotate(rootOrder.begin(), bestItr, bestItr + 1);
+                if (threadIndex == 0 && onIteration) onIteration(getSearchInfo(*state, rootMoves, bestResult, depth));
+                if (threadIndex == 0 && !timeManager.canStartIteration()) break;
+            }
 
-        MinimaxResult bestResult;
-        if (maximizingPlayer == board.getActivePlayer()) {
-            return maximize(board, maximizingPlayer, depth);
-        }
-        else {
-            return minimize(board, maximizingPlayer, depth);
+            // stopped inside the first iteration: the best-ordered move is the only guess there is
+            if (bestResult.moveIndex < 0) bestResult = { rootOrder[0], evaluateLeaf(*state, 0) };
+
+            bestResult.nodes = state->nodes;
+            bestResult.effectiveBranchingFactor = effectiveBranchingFactor;
+            return bestResult;
+        };
+
+        // helpers get threads of their own rather than pool tasks, which could sit queued behind other work until the
+        // main thread had already stopped
+        vector<future<MinimaxResult>> helpers;
+        for (int i = 1; i < threadCount; i++) {
+            helpers.push_back(std::async(std::launch::async, [&searchThread, i]() { return searchThread(i); }));
         }
 
-        return bestMove;
+        MinimaxResult bestResult = searchThread(0);
+        stop = true;
+        for (auto& helper : helpers) bestResult.nodes += helper.get().nodes;
+
+        return { bestResult.moveIndex, perspective * bestResult.moveScore, bestResult.nodes, bestResult.effectiveBranchingFactor };
     }
 
-    MinimaxResult multithreadingMinimax(const model::Board& board, const model::Piece::Color& maximizingPlayer, const int& depth) {
-        if (depth == 0) return { -1, evaluateBoard(board, maximizingPlayer) };
+}
 
-        MinimaxResult bestResult;
-        if (maximizingPlayer == board.getActivePlayer()) {
-            return multithreadingMaximize(board, maximizingPlayer, depth);
-        }
-        else {
-            return multithreadingMinimize(board, maximizingPlayer, depth);
-        }
+namespace chess::ai {
 
-        return bestMove;
+    TranspositionTable& getTranspositionTable() {
+        static TranspositionTable transpositionTable(DEFAULT_TRANSPOSITION_TABLE_MEGABYTES);
+        return transpositionTable;
     }
 
-}
\ No newline at end of file
+    MinimaxResult minimax(const model::Board& board, const model::Piece::Color& maximizingPlayer, const int& depth) {
+        SearchLimits limits;
+        limits.maxDepth = depth;
+        return iterativeDeepening(board, maximizingPlayer, limits, 1, getTranspositionTable(), nullptr);
+    }
+
+    MinimaxResult multithreadingMinimax(const model::Board& board, const model::Piece::Color& maximizingPlayer, const int& depth, const int& threadCount) {
+        SearchLimits limits;
+        limits.maxDepth = depth;
+        return iterativeDeepening(board, maximizingPlayer, limits, std::max(1, threadCount), getTranspositionTable(), nullptr);
+    }
+
+    MinimaxResult multithreadingMinimax(const model::Board& board, const model::Piece::Color& maximizingPlayer, const SearchLimits& limits, const int& threadCount,
+        const SearchInfoCallback& onIteration) {
+        return iterativeDeepening(board, maximizingPlayer, limits, std::max(1, threadCount), getTranspositionTable(), onIteration);
+    }
+
+    MinimaxResult multithreadingMinimax(const model::Board& board, const model::Piece::Color& maximizingPlayer, const SearchLimits& limits, const int& threadCount,
+        TranspositionTable& transpositionTable, const SearchInfoCallback& onIteration) {
+        return iterativeDeepening(board, maximizingPlayer, limits, std::max(1, threadCount), transpositionTable, onIteration);
+    }
+
+}
@@ -5,12 +5,50 @@
 
 
 #include "../../../MVC/Model/chess_model.h"
+#include "chess_ai_transposition_table.h"
+#include "../../chess_ai_time_manager.h"
+
+#include <vector>
+#include <optional>
+#include <functional>
+#include <chrono>
+#include <cstdint>
 
 
 
 namespace chess::ai {
 
+	struct MinimaxResult {
+		int moveIndex = -1; // index into the searched board's getAvailableMoves()
+		double moveScore = 0;
+		std::uint64_t nodes = 0; // visited by every thread of the search
+		double effectiveBranchingFactor = 0; // the main thread's nodes for its last depth over those for the depth before, or 0
+	};
+
+	// what the main thread knows after each iteration it completes
+	struct SearchInfo {
+		int depth;
+		double score; // from the point of view of the side to move at the root
+		std::optional<int> mateIn; // in plies, negative when the side to move is the one mated
+		std::uint64_t nodes; // visited by every thread so far, give or take one check interval per thread
+		std::chrono::milliseconds elapsed;
+		std::vector<model::Move> principalVariation; // the best root move, then the transposition table's replies
+	};
+
+	using SearchInfoCallback = std::function<void(const SearchInfo&)>;
+
+	// alpha-beta search deepened one ply at a time up to depth; scores are from maximizingPlayer's point of view
 	MinimaxResult minimax(const model::Board&, const model::Piece::Color& maximizingPlayer, const int& depth);
-	MinimaxResult multithreadingMinimax(const model::Board&, const model::Piece::Color& maximizingPlayer, const int& depth);
-
-}
\ No newline at end of file
+	// Lazy SMP: threadCount threads search the same root, sharing the transposition table
+	MinimaxResult multithreadingMinimax(const model::Board&, const model::Piece::Color& maximizingPlayer, const int& depth, const int& threadCount);
+	// as above, deepening until the first of limits is reached; the deepest completed iteration is kept. onIteration
+	// is called on the searching thread as each iteration completes
+	MinimaxResult multithreadingMinimax(const model::Board&, const model::Piece::Color& maximizingPlayer, const SearchLimits& limits, const int& threadCount,
+		const SearchInfoCallback& onIteration = nullptr);
+	// as above, with a table of the caller's own in place of the shared one, so searches side by side do not meet
+	MinimaxResult multithreadingMinimax(const model::Board&, const model::Piece::Color& maximizingPlayer, const SearchLimits& limits, const int& threadCount,
+		TranspositionTable& transpositionTable, const SearchInfoCallback& onIteration = nullptr);
+
+	TranspositionTable& getTranspositionTable(); // shared by every search in the process
+
+}
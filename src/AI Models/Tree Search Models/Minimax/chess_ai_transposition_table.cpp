@@ -0,0 +1,112 @@
+// chess_ai_transposition_table.cpp
+// by Jake Charles Osborne III
+
+
+
+#include "chess_ai_transposition_table.h"
+
+#include <memory>
+#include <atomic>
+#include <optional>
+#include <algorithm>
+#include <bit>
+
+using namespace chess::ai;
+
+using std::optional;
+using std::nullopt;
+
+
+
+namespace {
+
+    const std::uint8_t BOUND_MASK = 0x3;
+    const std::uint8_t GENERATION_STEP = 0x4;
+
+    std::uint64_t packData(float score, std::uint16_t bestMove, int depth, std::uint8_t generationAndBound) {
+        return std::uint64_t(std::bit_cast<std::uint32_t>(score)) |
+            std::uint64_t(bestMove) << 32 |
+            std::uint64_t(std::uint8_t(std::clamp(depth, 0, 255))) << 48 |
+            std::uint64_t(generationAndBound) << 56;
+    }
+
+    float scoreOf(std::uint64_t data) { return std::bit_cast<float>(std::uint32_t(data)); }
+    std::uint16_t bestMoveOf(std::uint64_t data) { return std::uint16_t(data >> 32); }
+    int depthOf(std::uint64_t data) { return int(std::uint8_t(data >> 48)); }
+    std::uint8_t generationAndBoundOf(std::uint64_t data) { return std::uint8_t(data >> 56); }
+
+}
+
+TranspositionTable::TranspositionTable(std::size_t megabytes) : bucketCount(0), generation(0) {
+    resize(megabytes);
+}
+
+// bucket count is rounded down to a power of two so the index is a mask of the key
+void TranspositionTable::resize(std::size_t megabytes) {
+    bucketCount = 1;
+    while (bucketCount * 2 * sizeof(Bucket) <= std::max<std::size_t>(megabytes, 1) * 1024 * 1024) bucketCount *= 2;
+
+    buckets = std::make_unique<Bucket[]>(bucketCount);
+    clear();
+}
+
+void TranspositionTable::clear() {
+    for (std::size_t i = 0; i < bucketCount; ++i) {
+        for (Entry& entry : buckets[i].entries) {
+            entry.keyXorData.store(0, std::memory_order_relaxed);
+            entry.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    generation = 0;
+}
+
+void TranspositionTable::newSearch() {
+    generation += GENERATION_STEP;
+}
+
+optional<TranspositionTable::Hit> TranspositionTable::probe(std::uint64_t key) const {
+    for (const Entry& entry : buckets[getBucketIndex(key)].entries) {
+        std::uint64_t data = entry.data.load(std::memory_order_relaxed);
+        std::uint64_t keyXorData = entry.keyXorData.load(std::memory_order_relaxed);
+
+        Bound bound = static_cast<Bound>(generationAndBoundOf(data) & BOUND_MASK);
+        if ((keyXorData ^ data) == key && bound != Bound::none) {
+            return Hit{ depthOf(data), bound, scoreOf(data), bestMoveOf(data) };
+        }
+    }
+    return nullopt;
+}
+
+void TranspositionTable::store(std::uint64_t key, int depth, Bound bound, double score, std::uint16_t bestMove) {
+    Entry* replaced = nullptr;
+    std::uint64_t replacedData = 0;
+    bool sameKey = false;
+
+    // prefer the entry already holding this position, then entries from older searches, then shallower ones
+    auto worth = [this](std::uint64_t data) {
+        bool current = (generationAndBoundOf(data) & ~BOUND_MASK) == generation;
+        return (current ? 256 : 0) + depthOf(data);
+    };
+    for (Entry& entry : buckets[getBucketIndex(key)].entries) {
+        std::uint64_t data = entry.data.load(std::memory_order_relaxed);
+        if ((entry.keyXorData.load(std::memory_order_relaxed) ^ data) == key) {
+            replaced = &entry;
+            replacedData = data;
+            sameKey = true;
+            break;
+        }
+        if (!replaced || worth(data) < worth(replacedData)) {
+            replaced = &entry;
+            replacedData = data;
+        }
+    }
+
+    if (sameKey && bestMove == 0) bestMove = bestMoveOf(replacedData);
+    std::uint64_t data = packData(float(score), bestMove, depth, std::uint8_t(generation | static_cast<std::uint8_t>(bound)));
+    replaced->data.store(data, std::memory_order_relaxed);
+    replaced->keyXorData.store(key ^ data, std::memory_order_relaxed);
+}
+
+std::size_t TranspositionTable::getBucketIndex(std::uint64_t key) const {
+    return std::size_t(key) & (bucketCount - 1);
+}
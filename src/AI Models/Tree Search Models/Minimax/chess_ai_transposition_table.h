@@ -0,0 +1,60 @@
+// chess_ai_transposition_table.h
+// by Jake Charles Osborne III
+#pragma once
+
+
+
+#include <memory>
+#include <atomic>
+#include <optional>
+#include <cstdint>
+#include <cstddef>
+
+
+
+namespace chess::ai {
+
+	// lock-free: each entry is stored as key ^ data next to data, so a torn write from another thread fails the key check
+	class TranspositionTable
+	{
+	public:
+
+		enum class Bound : std::uint8_t { none, exact, lower, upper };
+
+		struct Hit {
+			int depth;
+			Bound bound;
+			double score; // from the point of view of the side to move
+			std::uint16_t bestMove; // Move::getEncoding(), or 0 when unknown
+		};
+
+		explicit TranspositionTable(std::size_t megabytes);
+
+		void resize(std::size_t megabytes);
+		void clear();
+		void newSearch();
+
+		std::optional<Hit> probe(std::uint64_t key) const;
+		void store(std::uint64_t key, int depth, Bound bound, double score, std::uint16_t bestMove);
+
+	private:
+
+		struct Entry {
+			std::atomic<std::uint64_t> keyXorData;
+			std::atomic<std::uint64_t> data; // score bits, best move, depth, then generation and bound from the low bits up
+		};
+
+		static constexpr int BUCKET_SIZE = 4;
+
+		struct alignas(64) Bucket {
+			Entry entries[BUCKET_SIZE];
+		};
+
+		std::unique_ptr<Bucket[]> buckets;
+		std::size_t bucketCount;
+		std::uint8_t generation;
+
+		std::size_t getBucketIndex(std::uint64_t key) const;
+	};
+
+}
@@ -0,0 +1,136 @@
+// chess_ai.cpp
+// by Jake Charles Osborne III
+
+
+
+#include "chess_ai.h"
+#include "../MVC/Model/chess_model.h"
+#include "./Tree Search Models/Minimax/chess_ai_minimax.h"
+#include "chess_ai_time_manager.h"
+#include "./Opening Book/chess_ai_opening_book.h"
+
+#include <string>
+#include <optional>
+#include <thread>
+#include <future>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+
+using namespace chess;
+
+
+
+namespace {
+
+	ai::SearchLimits defaultSearchLimits() {
+		ai::SearchLimits limits;
+		limits.moveTime = std::chrono::milliseconds(1000);
+		return limits;
+	}
+
+	ai::SearchLimits searchLimits = defaultSearchLimits();
+	int threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+	// a search of the position after the opponent's predicted reply, running while they think
+	struct Ponder
+	{
+		model::Board board;
+		std::atomic<bool> pondering = true;
+		std::atomic<bool> stop = false;
+		std::future<ai::MinimaxResult> result;
+
+		~Ponder() { stop = true; } // the future then waits for a search that is already winding down
+	};
+
+	std::unique_ptr<Ponder> ponder;
+	std::unique_ptr<ai::OpeningBook> openingBook;
+
+	// positions answered without a search, which are the book's openings
+	std::optional<int> getKnownMove(const model::Board& board) {
+		if (!openingBook) return std::nullopt;
+		return openingBook->getMove(board);
+	}
+
+}
+
+namespace chess::ai {
+
+	// on a ponder hit the running search simply carries on under its limits, counted from when pondering began, so
+	// an opponent who took longer than the AI's budget gets a reply at once
+	int getMove(const model::Board& board) {
+		if (auto knownMove = getKnownMove(board)) {
+			stopPondering();
+			return *knownMove;
+		}
+		if (ponder && ponder->board.getHashKey() == board.getHashKey()) {
+			ponder->pondering = false;
+			int moveIndex = ponder->result.get().moveIndex;
+			ponder.reset();
+			return moveIndex;
+		}
+		return getMove(board, searchLimits);
+	}
+
+	int getMove(const model::Board& board, const SearchLimits& limits, const SearchInfoCallback& onIteration) {
+		stopPondering();
+		if (auto knownMove = getKnownMove(board)) return *knownMove;
+		getTranspositionTable().newSearch();
+		return multithreadingMinimax(board, board.getCurrentTurn(), limits, threadCount, onIteration).moveIndex;
+	}
+
+	// the predicted reply is the best move the last search stored for this position
+	void startPondering(const model::Board& board) {
+		stopPondering();
+
+		auto hit = getTranspositionTable().probe(board.getHashKey());
+		if (!hit || !hit->bestMove) return;
+		model::Move predictedMove(hit->bestMove);
+		auto availableMoves = board.getAvailableMoves();
+		if (std::find(availableMoves.begin(), availableMoves.end(), predictedMove) == availableMoves.end()) return;
+
+		ponder = std::make_unique<Ponder>();
+		ponder->board = board;
+		ponder->board.makeMove(predictedMove);
+		if (ponder->board.getAvailableMoves().empty()) {
+			ponder.reset();
+			return;
+		}
+
+		// registered once the table exists, so a ponder left running stops before it is destroyed
+		static std::once_flag stopsAtExit;
+		std::call_once(stopsAtExit, []() { std::atexit(stopPondering); });
+
+		SearchLimits limits = searchLimits;
+		limits.pondering = &ponder->pondering;
+		limits.stopSignal = &ponder->stop;
+		getTranspositionTable().newSearch();
+		ponder->result = std::async(std::launch::async, [pondered = ponder.get(), limits]() {
+			return multithreadingMinimax(pondered->board, pondered->board.getCurrentTurn(), limits, threadCount);
+		});
+	}
+
+	void stopPondering() {
+		ponder.reset();
+	}
+
+	void setSearchLimits(const SearchLimits& limits) {
+		searchLimits = limits;
+	}
+
+	void loadOpeningBook(const std::string& filename) {
+		openingBook = std::make_unique<OpeningBook>(filename);
+	}
+
+	void setTranspositionTableSize(std::size_t megabytes) {
+		getTranspositionTable().resize(megabytes);
+	}
+
+	void setThreadCount(int threads) {
+		threadCount = std::max(1, threads);
+	}
+
+}
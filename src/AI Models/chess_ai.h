@@ -0,0 +1,36 @@
+// chess_ai.h
+// by Jake Charles Osborne III
+#pragma once
+
+
+
+#include "../MVC/Model/chess_model.h"
+#include "chess_ai_time_manager.h"
+#include "./Tree Search Models/Minimax/chess_ai_minimax.h"
+
+#include <cstddef>
+#include <string>
+
+
+
+namespace chess::ai {
+
+	int getMove(const chess::model::Board& board); // index into board.getAvailableMoves(), searched within the set limits
+	// onIteration hears about each completed depth; book moves are returned without any
+	int getMove(const chess::model::Board& board, const SearchLimits& limits, const SearchInfoCallback& onIteration = nullptr);
+
+	void setSearchLimits(const SearchLimits& limits); // defaults to one second per move
+
+	// searches on the opponent's time, board being the position they are to move in. the next getMove(board) reuses
+	// the search if they played the predicted move and abandons it otherwise
+	void startPondering(const chess::model::Board& board);
+	void stopPondering();
+
+	// book positions are answered from the book without a search. throws std::runtime_error for a missing or malformed
+	// file, see OpeningBook for the format
+	void loadOpeningBook(const std::string& filename);
+
+	void setTranspositionTableSize(std::size_t megabytes);
+	void setThreadCount(int threads); // threads searching each move, defaults to one per hardware thread
+
+}
@@ -0,0 +1,72 @@
+// chess_ai_time_manager.cpp
+// by Jake Charles Osborne III
+
+
+
+#include "chess_ai_time_manager.h"
+#include "../MVC/Model/chess_model.h"
+
+#include <chrono>
+#include <algorithm>
+
+using namespace chess;
+using namespace chess::ai;
+using std::chrono::milliseconds;
+
+
+
+namespace {
+
+    // kept back from the clock for everything around the search itself
+    const milliseconds MOVE_OVERHEAD(30);
+    // assumed when the clock does not say how many moves it has to last
+    const int DEFAULT_MOVES_TO_GO = 30;
+    // a move may run past its share of the clock by this factor, never past the clock itself
+    const int HARD_LIMIT_FACTOR = 3;
+
+}
+
+namespace chess::ai {
+
+    // a new iteration usually costs more than every earlier one together, so none starts after half of a clock's
+    // budget. a fixed move time is used in full: iterations start until it runs out, and the last is cut off there
+    TimeManager::TimeManager(const SearchLimits& limits, const model::Piece::Color& sideToMove) :
+        start(std::chrono::steady_clock::now()), maxNodes(limits.maxNodes), stopSignal(limits.stopSignal), pondering(limits.pondering)
+    {
+        bool white = sideToMove == model::Piece::Color::white;
+        const std::optional<milliseconds>& clock = white ? limits.whiteTime : limits.blackTime;
+        milliseconds increment = white ? limits.whiteIncrement : limits.blackIncrement;
+
+        if (limits.moveTime) {
+            softDeadline = hardDeadline = start + std::max(milliseconds(1), *limits.moveTime);
+        }
+        else if (clock) {
+            milliseconds available = std::max(milliseconds(1), *clock - MOVE_OVERHEAD);
+            int movesToGo = std::max(1, limits.movesToGo.value_or(DEFAULT_MOVES_TO_GO));
+            milliseconds budget = std::clamp(*clock / movesToGo + increment * 3 / 4, milliseconds(1), available);
+            softDeadline = start + budget / 2;
+            hardDeadline = start + std::min(available, budget * HARD_LIMIT_FACTOR);
+        }
+    }
+
+    bool TimeManager::canStartIteration() const {
+        if (isPondering()) return true;
+        return !softDeadline || std::chrono::steady_clock::now() < *softDeadline;
+    }
+
+    bool TimeManager::isHardLimitReached(std::uint64_t nodes) const {
+        if (stopSignal && stopSignal->load(std::memory_order_relaxed)) return true;
+        if (isPondering()) return false;
+        if (maxNodes && nodes >= *maxNodes) return true;
+        return hardDeadline && std::chrono::steady_clock::now() >= *hardDeadline;
+    }
+
+    bool TimeManager::isPondering() const {
+        return pondering && pondering->load(std::memory_order_relaxed);
+    }
+
+    milliseconds TimeManager::getElapsed() const {
+        return std::chrono::duration_cast<milliseconds>(std::chrono::steady_clock::now() - start);
+    }
+
+}
@@ -0,0 +1,60 @@
+// chess_ai_time_manager.h
+// by Jake Charles Osborne III
+#pragma once
+
+
+
+#include "../MVC/Model/chess_model.h"
+
+#include <chrono>
+#include <optional>
+#include <atomic>
+#include <cstdint>
+
+
+
+namespace chess::ai {
+
+	// what bounds one search; the search stops at the first limit it reaches
+	struct SearchLimits
+	{
+		std::optional<std::chrono::milliseconds> moveTime; // exactly this long, regardless of the clocks
+		std::optional<std::chrono::milliseconds> whiteTime; // left on each side's clock
+		std::optional<std::chrono::milliseconds> blackTime;
+		std::chrono::milliseconds whiteIncrement{ 0 };
+		std::chrono::milliseconds blackIncrement{ 0 };
+		std::optional<int> movesToGo; // before the clocks are topped up, if they ever are
+		std::optional<std::uint64_t> maxNodes; // across every thread, honoured to within a few thousand nodes
+		int maxDepth = 64;
+		const std::atomic<bool>* stopSignal = nullptr; // raised by the caller to end the search early
+		// while this reads true no other limit applies; afterwards they apply as if counted from the search's start
+		const std::atomic<bool>* pondering = nullptr;
+	};
+
+	// turns a search's limits into deadlines once, when the search starts
+	class TimeManager
+	{
+	public:
+
+		TimeManager(const SearchLimits&, const chess::model::Piece::Color& sideToMove);
+
+		// between iterations: false once the next depth would likely not finish inside the budget
+		bool canStartIteration() const;
+		// during the search: true once the hard deadline or the node budget has passed
+		bool isHardLimitReached(std::uint64_t nodes) const;
+
+		std::chrono::milliseconds getElapsed() const;
+
+	private:
+
+		std::chrono::steady_clock::time_point start;
+		std::optional<std::chrono::steady_clock::time_point> softDeadline;
+		std::optional<std::chrono::steady_clock::time_point> hardDeadline;
+		std::optional<std::uint64_t> maxNodes;
+		const std::atomic<bool>* stopSignal;
+		const std::atomic<bool>* pondering;
+
+		bool isPondering() const;
+	};
+
+}
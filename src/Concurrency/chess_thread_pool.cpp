@@ -0,0 +1,110 @@
+// chess_thread_pool.cpp
+// by Jake Charles Osborne III
+
+
+
+#include "chess_thread_pool.h"
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <algorithm>
+
+using namespace chess::concurrency;
+
+
+
+namespace {
+
+    // set on each worker thread, so a pool knows its own workers from those of any other pool
+    thread_local const ThreadPool* workerPool = nullptr;
+    thread_local int workerIndex = -1;
+
+}
+
+ThreadPool::ThreadPool(unsigned threadCount) : pendingTasks(0), nextQueue(0), stopping(false) {
+    threadCount = std::max(1u, threadCount);
+    for (unsigned i = 0; i < threadCount; ++i) {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (unsigned i = 0; i < threadCount; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, int(i));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+    for (std::thread& worker : workers) worker.join();
+}
+
+ThreadPool& ThreadPool::getInstance() {
+    static ThreadPool threadPool(std::thread::hardware_concurrency());
+    return threadPool;
+}
+
+unsigned ThreadPool::getThreadCount() const {
+    return unsigned(workers.size());
+}
+
+// tasks submitted from one of this pool's workers stay on that worker's queue, others are dealt round robin
+void ThreadPool::push(std::function<void()> task) {
+    int ownIndex = getWorkerIndex();
+    int queueIndex = ownIndex >= 0 ? ownIndex : int(nextQueue++ % queues.size());
+    {
+        std::lock_guard<std::mutex> lock(queues[queueIndex]->mutex);
+        queues[queueIndex]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        ++pendingTasks;
+    }
+    wakeCondition.notify_one();
+}
+
+bool ThreadPool::runPendingTask() {
+    std::function<void()> task;
+
+    int ownIndex = getWorkerIndex();
+    int ownQueue = ownIndex >= 0 ? ownIndex : 0;
+    for (std::size_t i = 0; i < queues.size() && !task; ++i) {
+        WorkQueue& queue = *queues[(ownQueue + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) continue;
+
+        if (i == 0 && ownIndex >= 0) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+        else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+    }
+
+    if (!task) return false;
+    --pendingTasks;
+    task();
+    return true;
+}
+
+int ThreadPool::getWorkerIndex() const {
+    return workerPool == this ? workerIndex : -1;
+}
+
+void ThreadPool::workerLoop(int index) {
+    workerPool = this;
+    workerIndex = index;
+    while (true) {
+        if (runPendingTask()) continue;
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeCondition.wait(lock, [this]() { return stopping || pendingTasks > 0; });
+        if (stopping) return;
+    }
+}
@@ -0,0 +1,87 @@
+// chess_thread_pool.h
+// by Jake Charles Osborne III
+#pragma once
+
+
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <type_traits>
+
+
+
+namespace chess::concurrency {
+
+	// workers keep their own task deques, taking their newest task first and stealing the oldest from others when idle.
+	// meant for short tasks that finish on their own, such as perft's root moves and the games of a PGN file. work that
+	// runs until it is told to stop, like Lazy SMP helpers or EPD workers, takes threads of its own instead, since a
+	// task queued behind others could start after the search it was meant to help had already ended
+	class ThreadPool
+	{
+	public:
+
+		explicit ThreadPool(unsigned threadCount);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator =(const ThreadPool&) = delete;
+
+		static ThreadPool& getInstance(); // shared by the whole process, one worker per hardware thread
+
+		unsigned getThreadCount() const;
+
+		template<typename Function>
+		auto submit(Function&& function) -> std::future<std::invoke_result_t<Function>>;
+
+		// runs queued tasks while the result is not ready, so tasks may wait on tasks they submitted
+		template<typename T>
+		T wait(std::future<T>& future);
+
+	private:
+
+		struct WorkQueue {
+			std::mutex mutex;
+			std::deque<std::function<void()>> tasks;
+		};
+
+		std::vector<std::unique_ptr<WorkQueue>> queues;
+		std::vector<std::thread> workers;
+		std::atomic<int> pendingTasks;
+		std::atomic<unsigned> nextQueue;
+		std::atomic<bool> stopping;
+		std::mutex sleepMutex;
+		std::condition_variable wakeCondition;
+
+		int getWorkerIndex() const; // of the calling thread in this pool, or -1 on threads outside it
+		void push(std::function<void()> task);
+		bool runPendingTask();
+		void workerLoop(int index);
+	};
+
+	template<typename Function>
+	auto ThreadPool::submit(Function&& function) -> std::future<std::invoke_result_t<Function>> {
+		using Result = std::invoke_result_t<Function>;
+
+		auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+		std::future<Result> future = task->get_future();
+		push([task]() { (*task)(); });
+		return future;
+	}
+
+	template<typename T>
+	T ThreadPool::wait(std::future<T>& future) {
+		while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+			if (!runPendingTask()) future.wait_for(std::chrono::microseconds(100));
+		}
+		return future.get();
+	}
+
+}
@@ -3,7 +3,24 @@
 
 
 
-#include "./MVC/chess_control.h"
+#include "./MVC/Control/chess_control.h"
+#include "./MVC/Control/chess_uci.h"
+#include "./AI Models/Evaluation/chess_ai_evaluation.h"
+#include "./AI Models/Evaluation/chess_ai_nnue.h"
+#include "./AI Models/chess_ai.h"
+#include "./Tools/chess_pgn_reader.h"
+#include "./Tools/chess_epd_runner.h"
+#include "./Tools/chess_self_play.h"
+#include "./MVC/View/chess_view.h"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <stdexcept>
+#include <chrono>
+#include <algorithm>
+#include <cctype>
+#include <sstream>
 
 /*
        "A king may move a man, a father may claim a son, but that man can also move himself, and only then
@@ -15,6 +32,148 @@
                                                                 - King Baldwin IV (Kingdom of Heaven, 2005)
 */
 
-int main() {
+const char USAGE[] =
+	"usage: ConsoleChess [--heuristics <file>] [--nnue <file>] [--book <file>]\n"
+	"                    [uci | perft <depth> [--threads] [--fen <fen>] [moves...] | pgn <file> |\n"
+	"                     epd <file> [--movetime <ms>] [--nodes <count>] [--depth <plies>] [--json <file>] |\n"
+	"                     selfplay [--first <command>] [--second <command>] [--games <count>] [--concurrency <count>]\n"
+	"                              [--openings <file>] [--go <arguments>] [--pgn <file>]]\n";
+
+namespace {
+
+	// limits for each position of an epd run, one second each unless given
+	bool parseEpdOptions(const std::vector<std::string>& options, chess::ai::SearchLimits& limits, std::string& jsonFilename) {
+		if (options.size() % 2 != 0) return false;
+		bool limited = false;
+		for (std::size_t i = 0; i < options.size(); i += 2) {
+			const std::string& value = options[i + 1];
+			if (options[i] == "--json") {
+				jsonFilename = value;
+				continue;
+			}
+			if (value.empty() || value.size() > 12 || !std::all_of(value.begin(), value.end(), [](char c) { return std::isdigit(c); })) return false;
+			long long number = std::stoll(value);
+			if (options[i] == "--movetime") limits.moveTime = std::chrono::milliseconds(std::max(1LL, number));
+			else if (options[i] == "--nodes") limits.maxNodes = std::max(1LL, number);
+			else if (options[i] == "--depth") limits.maxDepth = int(std::clamp(number, 1LL, 64LL));
+			else return false;
+			limited = true;
+		}
+		if (!limited) limits.moveTime = std::chrono::milliseconds(1000);
+		return true;
+	}
+
+	// engines default to this program's own uci mode, and commands are split at spaces
+	bool parseSelfPlayOptions(const std::vector<std::string>& options, const std::string& program, chess::tools::SelfPlayOptions& selfPlay) {
+		if (options.size() % 2 != 0) return false;
+		std::string commands[2] = { program + " uci", program + " uci" };
+		for (std::size_t i = 0; i < options.size(); i += 2) {
+			const std::string& value = options[i + 1];
+			if (options[i] == "--first") commands[0] = value;
+			else if (options[i] == "--second") commands[1] = value;
+			else if (options[i] == "--openings") selfPlay.openings = chess::tools::loadOpenings(value);
+			else if (options[i] == "--go") selfPlay.goArguments = value;
+			else if (options[i] == "--pgn") selfPlay.pgnFilename = value;
+			else if (options[i] == "--games" || options[i] == "--concurrency") {
+				if (value.empty() || value.size() > 9 || !std::all_of(value.begin(), value.end(), [](char c) { return std::isdigit(c); })) return false;
+				(options[i] == "--games" ? selfPlay.games : selfPlay.concurrency) = std::stoi(value);
+			}
+			else return false;
+		}
+
+		chess::tools::EngineConfig* engines[2] = { &selfPlay.first, &selfPlay.second };
+		for (int i = 0; i < 2; ++i) {
+			std::istringstream command(commands[i]);
+			for (std::string argument; command >> argument;) engines[i]->commandLine.push_back(argument);
+			if (engines[i]->commandLine.empty()) return false;
+			engines[i]->name = commands[i] == commands[1 - i] ? commands[i] + (i ? " #2" : " #1") : commands[i];
+		}
+		return true;
+	}
+
+}
+
+int main(int argc, char* argv[]) {
+	std::vector<std::string> arguments(argv + 1, argv + argc);
+
+	while (arguments.size() >= 2 && (arguments[0] == "--heuristics" || arguments[0] == "--nnue" || arguments[0] == "--book")) {
+		try {
+			if (arguments[0] == "--heuristics") chess::ai::evaluation::loadHeuristics(arguments[1]);
+			else if (arguments[0] == "--nnue") chess::ai::evaluation::nnue::loadNetwork(arguments[1]);
+			else chess::ai::loadOpeningBook(arguments[1]);
+		}
+		catch (const std::runtime_error& error) {
+			std::cerr << error.what() << '\n';
+			return 1;
+		}
+		arguments.erase(arguments.begin(), arguments.begin() + 2);
+	}
+
+	if (!arguments.empty() && arguments[0] == "uci") {
+		chess::uci();
+		return 0;
+	}
+
+	if (!arguments.empty() && arguments[0] == "perft") {
+		if (!chess::perft(std::vector<std::string>(arguments.begin() + 1, arguments.end()))) {
+			std::cerr << USAGE;
+			return 1;
+		}
+		return 0;
+	}
+
+	// exits with 1 when any game has a move that cannot be played, so archives can be checked by scripts
+	if (!arguments.empty() && arguments[0] == "pgn") {
+		if (arguments.size() != 2) {
+			std::cerr << USAGE;
+			return 1;
+		}
+		try {
+			chess::tools::PgnReport report = chess::tools::readPgn(arguments[1]);
+			chess::view::printPgnReport(report);
+			return report.errors.empty() ? 0 : 1;
+		}
+		catch (const std::runtime_error& error) {
+			std::cerr << error.what() << '\n';
+			return 1;
+		}
+	}
+
+	if (!arguments.empty() && arguments[0] == "epd") {
+		chess::ai::SearchLimits limits;
+		std::string jsonFilename;
+		if (arguments.size() < 2 || !parseEpdOptions(std::vector<std::string>(arguments.begin() + 2, arguments.end()), limits, jsonFilename)) {
+			std::cerr << USAGE;
+			return 1;
+		}
+		try {
+			chess::tools::EpdReport report = chess::tools::runEpd(arguments[1], limits);
+			chess::view::printEpdReport(report);
+			if (!jsonFilename.empty()) chess::tools::writeEpdReport(report, jsonFilename);
+		}
+		catch (const std::runtime_error& error) {
+			std::cerr << error.what() << '\n';
+			return 1;
+		}
+		return 0;
+	}
+
+	if (!arguments.empty() && arguments[0] == "selfplay") {
+		chess::tools::SelfPlayOptions options;
+		try {
+			if (!parseSelfPlayOptions(std::vector<std::string>(arguments.begin() + 1, arguments.end()), argv[0], options)) {
+				std::cerr << USAGE;
+				return 1;
+			}
+			chess::tools::SelfPlayResult result = chess::tools::runSelfPlay(options, chess::view::printSelfPlayGame);
+			chess::view::printSelfPlayResult(result);
+		}
+		catch (const std::runtime_error& error) {
+			std::cerr << error.what() << '\n';
+			return 1;
+		}
+		return 0;
+	}
+
 	chess::play();
 }
\ No newline at end of file
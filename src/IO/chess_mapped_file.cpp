@@ -0,0 +1,130 @@
+// chess_mapped_file.cpp
+// by Jake Charles Osborne III
+
+
+
+#include "chess_mapped_file.h"
+
+#include <string>
+#include <stdexcept>
+#include <utility>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace chess::io;
+
+
+
+#if defined(_WIN32)
+
+MappedFile::MappedFile(const std::string& filename) : data(nullptr), size(0), fileHandle(nullptr), mappingHandle(nullptr) {
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) throw std::runtime_error(filename + " not available");
+    fileHandle = file;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        unmap();
+        throw std::runtime_error(filename + " not available");
+    }
+    size = std::size_t(fileSize.QuadPart);
+    if (size == 0) return;
+
+    mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle) data = static_cast<const std::uint8_t*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (!data) {
+        unmap();
+        throw std::runtime_error(filename + " could not be mapped");
+    }
+}
+
+void MappedFile::unmap() {
+    if (data) UnmapViewOfFile(data);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+    data = nullptr;
+    size = 0;
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept :
+    data(std::exchange(other.data, nullptr)),
+    size(std::exchange(other.size, 0)),
+    fileHandle(std::exchange(other.fileHandle, nullptr)),
+    mappingHandle(std::exchange(other.mappingHandle, nullptr))
+{}
+
+MappedFile& MappedFile::operator =(MappedFile&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        data = std::exchange(other.data, nullptr);
+        size = std::exchange(other.size, 0);
+        fileHandle = std::exchange(other.fileHandle, nullptr);
+        mappingHandle = std::exchange(other.mappingHandle, nullptr);
+    }
+    return *this;
+}
+
+#else
+
+// the descriptor can be closed as soon as the mapping exists
+MappedFile::MappedFile(const std::string& filename) : data(nullptr), size(0) {
+    int descriptor = open(filename.c_str(), O_RDONLY);
+    if (descriptor < 0) throw std::runtime_error(filename + " not available");
+
+    struct stat fileStatus;
+    if (fstat(descriptor, &fileStatus) != 0) {
+        close(descriptor);
+        throw std::runtime_error(filename + " not available");
+    }
+    size = std::size_t(fileStatus.st_size);
+
+    if (size > 0) {
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (mapping == MAP_FAILED) {
+            close(descriptor);
+            throw std::runtime_error(filename + " could not be mapped");
+        }
+        data = static_cast<const std::uint8_t*>(mapping);
+    }
+    close(descriptor);
+}
+
+void MappedFile::unmap() {
+    if (data) munmap(const_cast<std::uint8_t*>(data), size);
+    data = nullptr;
+    size = 0;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept :
+    data(std::exchange(other.data, nullptr)),
+    size(std::exchange(other.size, 0))
+{}
+
+MappedFile& MappedFile::operator =(MappedFile&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        data = std::exchange(other.data, nullptr);
+        size = std::exchange(other.size, 0);
+    }
+    return *this;
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+    unmap();
+}
+
+const std::uint8_t* MappedFile::getData() const { return data; }
+std::size_t MappedFile::getSize() const { return size; }
@@ -0,0 +1,43 @@
+// chess_mapped_file.h
+// by Jake Charles Osborne III
+#pragma once
+
+
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+
+
+namespace chess::io {
+
+	// a whole file mapped read-only into memory for as long as the object lives
+	class MappedFile
+	{
+	public:
+
+		explicit MappedFile(const std::string& filename); // throws std::runtime_error if the file cannot be mapped
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator =(const MappedFile&) = delete;
+		MappedFile(MappedFile&&) noexcept;
+		MappedFile& operator =(MappedFile&&) noexcept;
+
+		const std::uint8_t* getData() const;
+		std::size_t getSize() const;
+
+	private:
+
+		const std::uint8_t* data;
+		std::size_t size;
+#if defined(_WIN32)
+		void* fileHandle;
+		void* mappingHandle;
+#endif
+
+		void unmap();
+	};
+
+}
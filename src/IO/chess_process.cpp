@@ -0,0 +1,236 @@
+// chess_process.cpp
+// by Jake Charles Osborne III
+
+
+
+#include "chess_process.h"
+
+#include <string>
+#include <vector>
+#include <optional>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <csignal>
+#include <cerrno>
+#endif
+
+using namespace chess::io;
+using std::chrono::milliseconds;
+
+
+
+namespace {
+
+    const milliseconds EXIT_GRACE_PERIOD(1000);
+    const std::size_t READ_SIZE = 4096;
+
+}
+
+#if defined(_WIN32)
+
+// arguments are quoted so ones holding spaces survive; the child inherits only its own ends of the pipes
+Process::Process(const std::vector<std::string>& commandLine) : processHandle(nullptr), inputHandle(nullptr), outputHandle(nullptr) {
+    if (commandLine.empty()) throw std::runtime_error("no program to start");
+
+    SECURITY_ATTRIBUTES inheritable = { sizeof(SECURITY_ATTRIBUTES), nullptr, TRUE };
+    HANDLE childInput = nullptr, childOutput = nullptr;
+    HANDLE input = nullptr, output = nullptr;
+    if (!CreatePipe(&childInput, &input, &inheritable, 0) || !CreatePipe(&output, &childOutput, &inheritable, 0)) {
+        for (HANDLE handle : { childInput, input, output, childOutput }) if (handle) CloseHandle(handle);
+        throw std::runtime_error(commandLine[0] + " could not be started");
+    }
+    SetHandleInformation(input, HANDLE_FLAG_INHERIT, 0);
+    SetHandleInformation(output, HANDLE_FLAG_INHERIT, 0);
+
+    std::string command;
+    for (const auto& argument : commandLine) command += (command.empty() ? "\"" : " \"") + argument + '"';
+
+    STARTUPINFOA startupInfo = {};
+    startupInfo.cb = sizeof(startupInfo);
+    startupInfo.dwFlags = STARTF_USESTDHANDLES;
+    startupInfo.hStdInput = childInput;
+    startupInfo.hStdOutput = childOutput;
+    startupInfo.hStdError = GetStdHandle(STD_ERROR_HANDLE);
+    PROCESS_INFORMATION processInfo = {};
+    BOOL started = CreateProcessA(nullptr, command.data(), nullptr, nullptr, TRUE, 0, nullptr, nullptr, &startupInfo, &processInfo);
+    CloseHandle(childInput);
+    CloseHandle(childOutput);
+    if (!started) {
+        CloseHandle(input);
+        CloseHandle(output);
+        throw std::runtime_error(commandLine[0] + " could not be started");
+    }
+
+    CloseHandle(processInfo.hThread);
+    processHandle = processInfo.hProcess;
+    inputHandle = input;
+    outputHandle = output;
+}
+
+Process::~Process() {
+    CloseHandle(inputHandle);
+    if (WaitForSingleObject(processHandle, DWORD(EXIT_GRACE_PERIOD.count())) != WAIT_OBJECT_0) TerminateProcess(processHandle, 1);
+    CloseHandle(outputHandle);
+    CloseHandle(processHandle);
+}
+
+void Process::writeLine(const std::string& line) {
+    std::string data = line + '\n';
+    DWORD written = 0;
+    if (!WriteFile(inputHandle, data.data(), DWORD(data.size()), &written, nullptr) || written != data.size()) {
+        throw std::runtime_error("the process stopped reading its input");
+    }
+}
+
+// anonymous pipes cannot be waited on with a timeout, so they are polled
+std::optional<std::string> Process::readLine(milliseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (true) {
+        if (auto line = takeLine()) return line;
+
+        DWORD available = 0;
+        if (!PeekNamedPipe(outputHandle, nullptr, 0, nullptr, &available, nullptr)) return std::nullopt;
+        if (available == 0) {
+            if (std::chrono::steady_clock::now() >= deadline) return std::nullopt;
+            std::this_thread::sleep_for(milliseconds(1));
+            continue;
+        }
+
+        char chunk[READ_SIZE];
+        DWORD bytesRead = 0;
+        if (!ReadFile(outputHandle, chunk, DWORD(std::min<std::size_t>(available, READ_SIZE)), &bytesRead, nullptr) || bytesRead == 0) return std::nullopt;
+        buffer.append(chunk, bytesRead);
+    }
+}
+
+#else
+
+namespace {
+
+    // held from a pipe's creation until the fork, so where pipes cannot be made close-on-exec in one call, no
+    // process started by another thread can slip in before the flag is set
+    std::mutex startMutex;
+
+    bool openPipe(int (&descriptors)[2]) {
+#if defined(__linux__)
+        return pipe2(descriptors, O_CLOEXEC) == 0;
+#else
+        if (pipe(descriptors) != 0) return false;
+        if (fcntl(descriptors[0], F_SETFD, FD_CLOEXEC) == 0 && fcntl(descriptors[1], F_SETFD, FD_CLOEXEC) == 0) return true;
+        close(descriptors[0]);
+        close(descriptors[1]);
+        return false;
+#endif
+    }
+
+}
+
+// every pipe end is close-on-exec from the start, so children started by other threads never hold them open
+Process::Process(const std::vector<std::string>& commandLine) : processId(-1), inputDescriptor(-1), outputDescriptor(-1) {
+    if (commandLine.empty()) throw std::runtime_error("no program to start");
+
+    // a child that exits early must not take this process down with it on the next write
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::vector<char*> arguments;
+    for (const auto& argument : commandLine) arguments.push_back(const_cast<char*>(argument.c_str()));
+    arguments.push_back(nullptr);
+
+    std::unique_lock<std::mutex> lock(startMutex);
+    int toChild[2], fromChild[2];
+    if (!openPipe(toChild)) throw std::runtime_error(commandLine[0] + " could not be started");
+    if (!openPipe(fromChild)) {
+        close(toChild[0]);
+        close(toChild[1]);
+        throw std::runtime_error(commandLine[0] + " could not be started");
+    }
+
+    processId = fork();
+    if (processId == 0) {
+        dup2(toChild[0], STDIN_FILENO);
+        dup2(fromChild[1], STDOUT_FILENO);
+        execvp(arguments[0], arguments.data());
+        _exit(127);
+    }
+
+    lock.unlock();
+    close(toChild[0]);
+    close(fromChild[1]);
+    if (processId < 0) {
+        close(toChild[1]);
+        close(fromChild[0]);
+        throw std::runtime_error(commandLine[0] + " could not be started");
+    }
+    inputDescriptor = toChild[1];
+    outputDescriptor = fromChild[0];
+}
+
+Process::~Process() {
+    close(inputDescriptor);
+    auto deadline = std::chrono::steady_clock::now() + EXIT_GRACE_PERIOD;
+    while (waitpid(processId, nullptr, WNOHANG) == 0) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            kill(processId, SIGKILL);
+            waitpid(processId, nullptr, 0);
+            break;
+        }
+        std::this_thread::sleep_for(milliseconds(5));
+    }
+    close(outputDescriptor);
+}
+
+void Process::writeLine(const std::string& line) {
+    std::string data = line + '\n';
+    std::size_t written = 0;
+    while (written < data.size()) {
+        ssize_t result = write(inputDescriptor, data.data() + written, data.size() - written);
+        if (result < 0 && errno == EINTR) continue;
+        if (result <= 0) throw std::runtime_error("the process stopped reading its input");
+        written += std::size_t(result);
+    }
+}
+
+std::optional<std::string> Process::readLine(milliseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (true) {
+        if (auto line = takeLine()) return line;
+
+        auto remaining = std::chrono::duration_cast<milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0) return std::nullopt;
+        pollfd output = { outputDescriptor, POLLIN, 0 };
+        int ready = poll(&output, 1, int(remaining.count()));
+        if (ready < 0 && errno == EINTR) continue;
+        if (ready <= 0) return std::nullopt;
+
+        char chunk[READ_SIZE];
+        ssize_t bytesRead = read(outputDescriptor, chunk, READ_SIZE);
+        if (bytesRead < 0 && errno == EINTR) continue;
+        if (bytesRead <= 0) return std::nullopt;
+        buffer.append(chunk, std::size_t(bytesRead));
+    }
+}
+
+#endif
+
+std::optional<std::string> Process::takeLine() {
+    std::size_t lineEnd = buffer.find('\n');
+    if (lineEnd == std::string::npos) return std::nullopt;
+    std::string line = buffer.substr(0, lineEnd);
+    buffer.erase(0, lineEnd + 1);
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    return line;
+}
@@ -0,0 +1,48 @@
+// chess_process.h
+// by Jake Charles Osborne III
+#pragma once
+
+
+
+#include <string>
+#include <vector>
+#include <optional>
+#include <chrono>
+
+
+
+namespace chess::io {
+
+	// a child program spoken to a line at a time through its standard input and output, such as a UCI engine
+	class Process
+	{
+	public:
+
+		// the first argument names the program, searched for on the PATH. throws std::runtime_error if it cannot start
+		explicit Process(const std::vector<std::string>& commandLine);
+		~Process(); // closes the child's input, then ends it if it has not exited within a second
+
+		Process(const Process&) = delete;
+		Process& operator =(const Process&) = delete;
+
+		void writeLine(const std::string& line); // throws std::runtime_error once the child has stopped reading
+		// the next line without its line ending, or nothing if the child exits or says nothing more within timeout
+		std::optional<std::string> readLine(std::chrono::milliseconds timeout);
+
+	private:
+
+#if defined(_WIN32)
+		void* processHandle;
+		void* inputHandle;
+		void* outputHandle;
+#else
+		int processId;
+		int inputDescriptor;
+		int outputDescriptor;
+#endif
+		std::string buffer; // read from the child but not yet returned
+
+		std::optional<std::string> takeLine();
+	};
+
+}
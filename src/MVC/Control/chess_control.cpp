@@ -5,14 +5,19 @@
 
 #include "../../MVC/Model/chess_model.h"
 #include "../../MVC/View/chess_view.h"
-#include "../AI_Models/chess_ai.h"
+#include "../../AI Models/chess_ai.h"
+#include "../../Tools/chess_perft.h"
 
 #include <iostream>
+#include <sstream>
 #include <vector>
 #include <unordered_set>
 #include <string>
 #include <tuple>
 #include <optional>
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
 
 using namespace chess;
 
@@ -36,10 +41,23 @@ namespace {
 		reset,
 		aiWhite,
 		aiBlack,
+		perft,
 		exitGame,
 		invalidAction
 	};
 
+	// moves typed without a promotion piece promote to a queen
+	bool isUnderpromotion(const model::Move& move) {
+		return move.isPromotion() && move.getPromotionType() != model::Piece::Type::queen;
+	}
+
+	optional<int> getAlgebraicNotationPrefixMove(const string& input, const model::Board& board);
+	optional<int> getAlgebraicNotationCaptureMove(const string& input, const model::Board& board);
+	optional<int> getAlgebraicNotationPrefixCaptureMove(const string& input, const model::Board& board);
+	optional<int> getKingsideCastlingMove(const model::Board& board);
+	optional<int> getQueensideCastlingMove(const model::Board& board);
+	bool runPerft(const vector<string>& arguments, model::Board board);
+
 	void processUserAction(
 		UserAction& userAction,
 		string& input,
@@ -55,8 +73,9 @@ namespace {
 			optional<int> optIndex = nullopt;
 			auto availableMoves = board.getAvailableMoves();
 			for (int i = 0; i < availableMoves.size(); ++i) {
-				if ((!selectedPiece || availableMoves[i].from == *selectedPiece) &&
-					availableMoves[i].to == indicatedPosition)
+				if ((!selectedPiece || availableMoves[i].getFrom() == *selectedPiece) &&
+					availableMoves[i].getTo() == indicatedPosition &&
+					!isUnderpromotion(availableMoves[i]))
 				{
 					optIndex = i;
 					break;
@@ -71,8 +90,8 @@ namespace {
 			else {
 				if (!selectedPiece) {
 					for (const auto& move : availableMoves) {
-						if (move.from == indicatedPosition) {
-							selectedPiece = move.from;
+						if (move.getFrom() == indicatedPosition) {
+							selectedPiece = move.getFrom();
 							message = "Piece at " + string(1, selectedPiece->x) + string(1, '0' + selectedPiece->y) + " selected.";
 							view::updateBoardString(board, selectedPiece);
 						}
@@ -136,7 +155,7 @@ namespace {
 			message = "Moves are available for pieces on the following positions: ";
 			unordered_set<model::Piece::Position> movablePieces;
 			for (const model::Move& availableMove : board.getAvailableMoves()) {
-				movablePieces.insert(availableMove.from);
+				movablePieces.insert(availableMove.getFrom());
 			}
 			for (const auto& movablePiece : movablePieces) {
 				message += " " + string(1, movablePiece.x) + string(1, '0' + movablePiece.y);
@@ -170,6 +189,24 @@ namespace {
 			message = "Game reset with AI enabled as black.";
 			view::updateBoardString(board, selectedPiece);
 			break;
+
+		case UserAction::perft: {
+			std::istringstream inputStream(input);
+			vector<string> arguments;
+			string argument;
+			inputStream >> argument;
+			while (inputStream >> argument) arguments.push_back(argument);
+
+			if (runPerft(arguments, board)) {
+				view::printMessage("Press enter to resume the game.");
+				view::promptUser();
+				message = "Perft complete.";
+			}
+			else {
+				message = "Usage: perft <depth> [--threads] [--fen <fen>] [moves...]";
+			}
+			break;
+		}
 		}
 	}
 
@@ -180,8 +217,9 @@ namespace {
 
 		auto availableMoves = board.getAvailableMoves();
 		for (int i = 0; i < availableMoves.size(); ++i) {
-			if (availableMoves[i].to.x == input[0] &&
-				'0' + availableMoves[i].to.y == input[1])
+			if (availableMoves[i].getTo().x == input[0] &&
+				'0' + availableMoves[i].getTo().y == input[1] &&
+				!isUnderpromotion(availableMoves[i]))
 			{
 				if (!optMoveIndex) optMoveIndex = i;
 				else return nullopt;
@@ -203,9 +241,10 @@ namespace {
 
 		auto availableMoves = board.getAvailableMoves();
 		for (int i = 0; i < availableMoves.size(); ++i) {
-			if (possibleFroms.find(availableMoves[i].from) != possibleFroms.end() &&
-				availableMoves[i].to.x == input[1] &&
-				'0' + availableMoves[i].to.y == input[2])
+			if (possibleFroms.find(availableMoves[i].getFrom()) != possibleFroms.end() &&
+				availableMoves[i].getTo().x == input[1] &&
+				'0' + availableMoves[i].getTo().y == input[2] &&
+				!isUnderpromotion(availableMoves[i]))
 			{
 				if (!optMoveIndex) optMoveIndex = i;
 				else return nullopt;
@@ -228,8 +267,9 @@ namespace {
 		optional<int> optMoveIndex = nullopt;
 		auto availableMoves = board.getAvailableMoves();
 		for (int i = 0; i < availableMoves.size(); ++i) {
-			if (possibleFroms.find(availableMoves[i].from) != possibleFroms.end() &&
-				possibleTos.find(availableMoves[i].to) != possibleTos.end())
+			if (possibleFroms.find(availableMoves[i].getFrom()) != possibleFroms.end() &&
+				possibleTos.find(availableMoves[i].getTo()) != possibleTos.end() &&
+				!isUnderpromotion(availableMoves[i]))
 			{
 				if (!optMoveIndex) optMoveIndex = i;
 				else return nullopt;
@@ -252,8 +292,9 @@ namespace {
 		optional<int> optMoveIndex = nullopt;
 		auto availableMoves = board.getAvailableMoves();
 		for (int i = 0; i < availableMoves.size(); ++i) {
-			if (possibleFroms.find(availableMoves[i].from) != possibleFroms.end() &&
-				possibleTos.find(availableMoves[i].to) != possibleTos.end())
+			if (possibleFroms.find(availableMoves[i].getFrom()) != possibleFroms.end() &&
+				possibleTos.find(availableMoves[i].getTo()) != possibleTos.end() &&
+				!isUnderpromotion(availableMoves[i]))
 			{
 				if (!optMoveIndex) optMoveIndex = i;
 				else return nullopt;
@@ -266,15 +307,9 @@ namespace {
 	optional<int> getKingsideCastlingMove(const model::Board& board) {
 		optional<int> optMoveIndex = nullopt;
 
-		vector<model::Piece::Position> kings;
-		for (const auto& [notation, color, position] : board.getPieces()) {
-			if (board.getCurrentTurn() == color && tolower(notation) == 'k') {
-				kings.push_back(position);
-			}
-		}
 		auto moves = board.getAvailableMoves();
 		for (int i = 0; i < moves.size(); ++i) {
-			if (std::find(kings.begin(), kings.end(), moves[i].from) != kings.end() && moves[i].to.x == moves[i].from.x + 2) {
+			if (moves[i].getFlag() == model::Move::kingsideCastle) {
 				if (!optMoveIndex) optMoveIndex = i;
 				else return nullopt;
 			}
@@ -286,15 +321,9 @@ namespace {
 	optional<int> getQueensideCastlingMove(const model::Board& board) {
 		optional<int> optMoveIndex = nullopt;
 
-		vector<model::Piece::Position> kings;
-		for (const auto& [notation, color, position] : board.getPieces()) {
-			if (board.getCurrentTurn() == color && tolower(notation) == 'k') {
-				kings.push_back(position);
-			}
-		}
 		auto moves = board.getAvailableMoves();
 		for (int i = 0; i < moves.size(); ++i) {
-			if (std::find(kings.begin(), kings.end(), moves[i].from) != kings.end() && moves[i].to.x == moves[i].from.x - 2) {
+			if (moves[i].getFlag() == model::Move::queensideCastle) {
 				if (!optMoveIndex) optMoveIndex = i;
 				else return nullopt;
 			}
@@ -303,7 +332,74 @@ namespace {
 		return optMoveIndex;
 	}
 
+	// long algebraic coordinates such as "e2e4", with an optional promotion piece as in "e7e8n"
+	optional<int> getCoordinateMove(const string& input, const model::Board& board) {
+		if (input.size() != 4 && input.size() != 5) return nullopt;
+
+		string notation = input;
+		for (auto& notationChar : notation) notationChar = tolower(notationChar);
+
+		auto availableMoves = board.getAvailableMoves();
+		for (int i = 0; i < availableMoves.size(); ++i) {
+			string moveNotation = availableMoves[i].getCoordinateNotation();
+			if (moveNotation == notation || moveNotation == notation + 'q') return i;
+		}
+
+		return nullopt;
+	}
+
+	bool isNumber(const string& argument) {
+		return !argument.empty() && std::all_of(argument.begin(), argument.end(), [](char c) { return std::isdigit(c); });
+	}
+
+	// arguments are the depth followed by an optional "--threads" flag, an optional "--fen" position to start from
+	// instead of the given board, and moves played from there. the FEN is either one argument or its four to six fields
+	bool runPerft(const vector<string>& arguments, model::Board board) {
+		if (arguments.empty() || arguments[0].size() > 2 || !isNumber(arguments[0])) return false;
+
+		int depth = std::stoi(arguments[0]);
+		bool multithreaded = false;
+		bool movesPlayed = false;
+		for (std::size_t i = 1; i < arguments.size(); ++i) {
+			if (arguments[i] == "--threads") {
+				multithreaded = true;
+				continue;
+			}
+
+			if (arguments[i] == "--fen" && !movesPlayed && i + 1 < arguments.size()) {
+				string fen = arguments[++i];
+				if (fen.find(' ') == string::npos) {
+					if (i + 3 >= arguments.size()) return false;
+					for (int field = 0; field < 3; ++field) fen += ' ' + arguments[++i];
+					if (i + 2 < arguments.size() && isNumber(arguments[i + 1]) && isNumber(arguments[i + 2])) {
+						fen += ' ' + arguments[i + 1] + ' ' + arguments[i + 2];
+						i += 2;
+					}
+				}
+				try {
+					board.setFEN(fen);
+				}
+				catch (const std::invalid_argument& error) {
+					view::printMessage(error.what());
+					return false;
+				}
+				continue;
+			}
+
+			optional<int> moveIndex = getCoordinateMove(arguments[i], board);
+			if (!moveIndex) return false;
+			board.makeMove(*moveIndex);
+			movesPlayed = true;
+		}
+
+		view::printPerftResults(tools::perft(board, depth, multithreaded));
+		return true;
+	}
+
 	UserAction parseInput(string& input, const model::Board& board) {
+		// kept as typed, since a FEN among the arguments is case sensitive
+		if (input.rfind("perft ", 0) == 0) return UserAction::perft;
+
 		for (auto& inputChar : input) inputChar = tolower(inputChar);
 
 		if (input.size() == 2 && std::isalpha(input[0]) && std::isdigit(input[1])) return UserAction::indicatePosition;
@@ -326,6 +422,10 @@ namespace {
 
 namespace chess {
 
+	bool perft(const vector<string>& arguments) {
+		return runPerft(arguments, model::Board());
+	}
+
 	void play() {
 		string input;
 		UserAction userAction = invalidAction;
@@ -333,16 +433,18 @@ namespace chess {
 			model::Board board;
 			optional<model::Piece::Position> selectedPiece = nullopt;
 			optional<model::Piece::Color> ai = nullopt;
+			auto isAiTurn = [&ai, &board]() { return ai == board.getCurrentTurn(); };
 
 			view::updateBoardString(board, selectedPiece);
 
 			string message = "Game start. Enter 'help' for a list of commands.";
-			while (std::cin && !board.getAvailableMoves().empty()) {
-				if (ai && *ai == board.getCurrentTurn()) {
+			while (std::cin && !board.getAvailableMoves().empty() && !board.hasInsufficientMaterial()) {
+				if (isAiTurn()) {
 					board.makeMove(chess::ai::getMove(board));
 					message = "AI move complete.";
 				}
 				else {
+					if (ai) chess::ai::startPondering(board);
 					do {
 						view::printHeader();
 						view::printCurrentTurn(board);
@@ -352,14 +454,22 @@ namespace chess {
 
 						userAction = parseInput(input, board);
 						processUserAction(userAction, input, board, selectedPiece, ai, message);
-					} while (std::cin && userAction != exitGame);
+					} while (std::cin && userAction != exitGame && !isAiTurn() &&
+						!board.getAvailableMoves().empty() && !board.hasInsufficientMaterial());
+					if (!isAiTurn()) chess::ai::stopPondering();
+					if (userAction == exitGame) break;
 				}
 
 				view::updateBoardString(board, selectedPiece);
 			}
+			chess::ai::stopPondering();
+			if (userAction == exitGame) break;
 
 			view::printHeader();
-			if (board.pieceToCaptureInCheck(board.getCurrentTurn())) {
+			if (board.hasInsufficientMaterial()) {
+				view::printMessage("Draw by insufficient material!");
+			}
+			else if (board.pieceToCaptureInCheck(board.getCurrentTurn())) {
 				if (board.getCurrentTurn() == model::Piece::Color::white) view::printMessage("Black Wins!");
 				else /*board.getCurrentTurn() == Piece::Color::black*/ view::printMessage("White Wins!");
 			}
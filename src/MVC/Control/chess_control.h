@@ -4,6 +4,12 @@
 
 
 
+#include <vector>
+#include <string>
+
+
+
 namespace chess {
 	void play();
+	bool perft(const std::vector<std::string>& arguments);
 }
\ No newline at end of file
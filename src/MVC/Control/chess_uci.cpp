@@ -0,0 +1,236 @@
+// chess_uci.cpp
+// by Jake Charles Osborne III
+
+
+
+#include "chess_uci.h"
+#include "../../MVC/Model/chess_model.h"
+#include "../../AI Models/chess_ai.h"
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <optional>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace chess;
+
+using std::string;
+using std::vector;
+using std::optional;
+using std::nullopt;
+using std::chrono::milliseconds;
+
+
+
+namespace {
+
+	const int DEFAULT_HASH_MEGABYTES = 16;
+	const int MAX_HASH_MEGABYTES = 65536;
+	const int MAX_THREADS = 512;
+
+	// the search thread and the command loop both write to the GUI, one whole line at a time
+	std::mutex outputMutex;
+
+	void send(const string& line) {
+		std::lock_guard<std::mutex> lock(outputMutex);
+		std::cout << line << std::endl;
+	}
+
+	// one "go" at a time, on its own thread so "stop" is read and acted on while it runs
+	struct Search
+	{
+		std::thread thread;
+		std::atomic<bool> stop = false;
+		std::atomic<bool> pondering = false;
+		bool infinite = false;
+		// infinite and ponder searches that finish early hold their bestmove until "stop" or "ponderhit"
+		std::mutex releaseMutex;
+		std::condition_variable released;
+
+		void release() {
+			{ std::lock_guard<std::mutex> lock(releaseMutex); }
+			released.notify_all();
+		}
+
+		bool isHeld() const { return !stop && (infinite || pondering); }
+	};
+
+	std::unique_ptr<Search> search;
+
+	void stopSearch() {
+		if (!search) return;
+		search->stop = true;
+		search->release();
+		search->thread.join();
+		search.reset();
+	}
+
+	optional<model::Move> getMove(const string& notation, const model::Board& board) {
+		for (const auto& move : board.getAvailableMoves()) {
+			if (move.getCoordinateNotation() == notation) return move;
+		}
+		return nullopt;
+	}
+
+	string toInfoString(const ai::SearchInfo& info) {
+		std::ostringstream line;
+		line << "info depth " << info.depth;
+		if (info.mateIn) line << " score mate " << (*info.mateIn > 0 ? (*info.mateIn + 1) / 2 : *info.mateIn / 2);
+		else line << " score cp " << std::lround(info.score * 100);
+		long long elapsed = std::max<long long>(1, info.elapsed.count());
+		line << " nodes " << info.nodes << " nps " << info.nodes * 1000 / elapsed << " time " << info.elapsed.count() << " pv";
+		for (const auto& move : info.principalVariation) line << ' ' << move.getCoordinateNotation();
+		return line.str();
+	}
+
+	// "position startpos|fen <fields> [moves <move>...]"; the board is left as it was if any part is not understood
+	void setPosition(std::istringstream& arguments, model::Board& board) {
+		string token;
+		arguments >> token;
+		model::Board newBoard;
+		if (token == "fen") {
+			string fen;
+			while (arguments >> token && token != "moves") fen += token + ' ';
+			try {
+				newBoard.setFEN(fen);
+			}
+			catch (const std::invalid_argument& error) {
+				send(string("info string ") + error.what());
+				return;
+			}
+		}
+		else if (token != "startpos") return;
+		else if (arguments >> token && token != "moves") return;
+
+		while (arguments >> token) {
+			auto move = getMove(token, newBoard);
+			if (!move) {
+				send("info string illegal move " + token);
+				return;
+			}
+			newBoard.makeMove(*move);
+		}
+		board = newBoard;
+	}
+
+	void startSearch(std::istringstream& arguments, const model::Board& board) {
+		stopSearch();
+		search = std::make_unique<Search>();
+
+		ai::SearchLimits limits;
+		string token;
+		while (arguments >> token) {
+			long long value = 0;
+			if (token == "infinite") search->infinite = true;
+			else if (token == "ponder") search->pondering = true;
+			else if (!(arguments >> value)) break;
+			else if (token == "depth") limits.maxDepth = std::max<long long>(1, value);
+			else if (token == "movetime") limits.moveTime = milliseconds(value);
+			else if (token == "nodes") limits.maxNodes = std::max<long long>(1, value);
+			else if (token == "wtime") limits.whiteTime = milliseconds(value);
+			else if (token == "btime") limits.blackTime = milliseconds(value);
+			else if (token == "winc") limits.whiteIncrement = milliseconds(value);
+			else if (token == "binc") limits.blackIncrement = milliseconds(value);
+			else if (token == "movestogo") limits.movesToGo = int(value);
+		}
+		limits.stopSignal = &search->stop;
+		limits.pondering = &search->pondering;
+
+		search->thread = std::thread([current = search.get(), board, limits]() {
+			vector<model::Move> principalVariation;
+			string bestMove = "0000";
+			auto availableMoves = board.getAvailableMoves();
+			if (!availableMoves.empty()) {
+				int moveIndex = ai::getMove(board, limits, [&principalVariation](const ai::SearchInfo& info) {
+					principalVariation = info.principalVariation;
+					send(toInfoString(info));
+				});
+				bestMove = availableMoves[moveIndex].getCoordinateNotation();
+			}
+
+			std::unique_lock<std::mutex> lock(current->releaseMutex);
+			current->released.wait(lock, [current]() { return !current->isHeld(); });
+			lock.unlock();
+
+			string line = "bestmove " + bestMove;
+			if (principalVariation.size() >= 2 && principalVariation[0].getCoordinateNotation() == bestMove) {
+				line += " ponder " + principalVariation[1].getCoordinateNotation();
+			}
+			send(line);
+		});
+	}
+
+	// "setoption name <id> [value <x>]"; only Hash and Threads change anything
+	void setOption(std::istringstream& arguments) {
+		string token, name, value;
+		arguments >> token;
+		if (token != "name") return;
+		while (arguments >> token && token != "value") name += (name.empty() ? "" : " ") + token;
+		std::getline(arguments >> std::ws, value);
+
+		try {
+			if (name == "Hash") {
+				stopSearch();
+				ai::setTranspositionTableSize(std::clamp(std::stoi(value), 1, MAX_HASH_MEGABYTES));
+			}
+			else if (name == "Threads") ai::setThreadCount(std::clamp(std::stoi(value), 1, MAX_THREADS));
+		}
+		catch (const std::exception&) {
+			send("info string invalid value for " + name);
+		}
+	}
+
+}
+
+namespace chess {
+
+	void uci() {
+		model::Board board;
+		string input;
+		while (std::getline(std::cin, input)) {
+			std::istringstream arguments(input);
+			string command;
+			arguments >> command;
+
+			if (command == "uci") {
+				int threads = std::max(1u, std::thread::hardware_concurrency());
+				send("id name ConsoleChess");
+				send("id author Jake Charles Osborne III");
+				send("option name Hash type spin default " + std::to_string(DEFAULT_HASH_MEGABYTES) + " min 1 max " + std::to_string(MAX_HASH_MEGABYTES));
+				send("option name Threads type spin default " + std::to_string(threads) + " min 1 max " + std::to_string(MAX_THREADS));
+				send("option name Ponder type check default false");
+				send("uciok");
+			}
+			else if (command == "isready") send("readyok");
+			else if (command == "setoption") setOption(arguments);
+			else if (command == "ucinewgame") {
+				stopSearch();
+				ai::getTranspositionTable().clear();
+				board = model::Board();
+			}
+			else if (command == "position") {
+				stopSearch();
+				setPosition(arguments, board);
+			}
+			else if (command == "go") startSearch(arguments, board);
+			else if (command == "stop") stopSearch();
+			else if (command == "ponderhit" && search) {
+				search->pondering = false;
+				search->release();
+			}
+			else if (command == "quit") break;
+		}
+		stopSearch();
+	}
+
+}
@@ -0,0 +1,10 @@
+// chess_uci.h
+// by Jake Charles Osborne III
+#pragma once
+
+
+
+namespace chess {
+	// reads Universal Chess Interface commands from standard input until "quit" or the end of input
+	void uci();
+}
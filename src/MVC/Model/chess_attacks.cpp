@@ -0,0 +1,126 @@
+// chess_attacks.cpp
+// by Jake Charles Osborne III
+
+
+
+#include "chess_attacks.h"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+using namespace chess::model;
+using namespace chess::model::attacks;
+
+
+
+namespace {
+
+    const int BISHOP_DIRECTIONS[4][2] = { {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
+    const int ROOK_DIRECTIONS[4][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+
+    // every relevant occupancy of every square: 5248 bishop and 102400 rook entries
+    const std::size_t BISHOP_TABLE_SIZE = 5248;
+    const std::size_t ROOK_TABLE_SIZE = 102400;
+    Bitboard SLIDER_ATTACKS[BISHOP_TABLE_SIZE + ROOK_TABLE_SIZE];
+
+    // walks each ray until it leaves the board or hits an occupied square; only used to fill the tables
+    Bitboard getRayAttacks(int square, Bitboard occupied, const int (&directions)[4][2]) {
+        Bitboard attacks = 0;
+        for (const auto& [dx, dy] : directions) {
+            int x = square % 8 + dx;
+            int y = square / 8 + dy;
+            while (x >= 0 && x < 8 && y >= 0 && y < 8) {
+                Bitboard bit = Bitboard(1) << (y * 8 + x);
+                attacks |= bit;
+                if (occupied & bit) break;
+                x += dx;
+                y += dy;
+            }
+        }
+        return attacks;
+    }
+
+    // the squares a ray passes before its last one, since a piece on the edge never blocks anything further
+    Bitboard getRelevantMask(int square, const int (&directions)[4][2]) {
+        Bitboard mask = 0;
+        for (const auto& [dx, dy] : directions) {
+            int x = square % 8 + dx;
+            int y = square / 8 + dy;
+            while (x + dx >= 0 && x + dx < 8 && y + dy >= 0 && y + dy < 8) {
+                mask |= Bitboard(1) << (y * 8 + x);
+                x += dx;
+                y += dy;
+            }
+        }
+        return mask;
+    }
+
+    // found offline by trying sparse random numbers until no two occupancies with different attacks shared an index
+    const Bitboard BISHOP_MAGICS[64] = {
+        0x10102002004A1420ULL, 0x8020040400584008ULL, 0x10510800811201C8ULL, 0x5204042080000088ULL,
+        0x2204106880000002ULL, 0x1401042004000000ULL, 0x0400880410042004ULL, 0x0028208200A02020ULL,
+        0x1500241990010E00ULL, 0x8001200182020A40ULL, 0x40004101030B0000ULL, 0x8002041042000100ULL,
+        0x4010011041020038ULL, 0x0000010421044000ULL, 0x1500210808020A00ULL, 0x8000088400880520ULL,
+        0x0405004010040100ULL, 0x1005823210040108ULL, 0x2708008102040011ULL, 0x4048200404009100ULL,
+        0x0018104101400024ULL, 0x0003000601190101ULL, 0x8004803108491000ULL, 0x8014241200820800ULL,
+        0x0006E080100C3040ULL, 0x0501044A11041800ULL, 0x9020300008004045ULL, 0x0894080000220040ULL,
+        0x1001010083104000ULL, 0x5004030040900080ULL, 0x000400422C012400ULL, 0x0002128698404812ULL,
+        0x1010108404900440ULL, 0x0928021182084100ULL, 0x2006080409020024ULL, 0x1010202020180080ULL,
+        0xA010008200202200ULL, 0x2098015100019004ULL, 0x0002041440810811ULL, 0x802A02020000B098ULL,
+        0x0009015090004060ULL, 0x4000821082081001ULL, 0x0100210040420800ULL, 0x0800004010488A00ULL,
+        0x2000081104004040ULL, 0x4C8E029015000082ULL, 0x0420340322224842ULL, 0x1298260043400210ULL,
+        0x0000822802400008ULL, 0x00008A0101600000ULL, 0x3040003412080021ULL, 0x3040290220884800ULL,
+        0x4A1500401041004AULL, 0x8010200282020781ULL, 0x0020203142209091ULL, 0x0070300600902110ULL,
+        0x0040808800B62048ULL, 0x0000810400C44420ULL, 0x00080400440C0441ULL, 0x8340080020840411ULL,
+        0x0000000104208200ULL, 0x0000800810D00080ULL, 0x0400530411080200ULL, 0x4040702400932244ULL
+    };
+
+    const Bitboard ROOK_MAGICS[64] = {
+        0x1080004008801020ULL, 0x0840092002C03000ULL, 0x1900200010400900ULL, 0x0880100008000480ULL,
+        0x4200100420080200ULL, 0x8100020100080400ULL, 0x0200040110886200ULL, 0x0200008040220411ULL,
+        0x0404800084400220ULL, 0x0000401000402000ULL, 0x0086001081220440ULL, 0x0408800800100280ULL,
+        0x000A001201040820ULL, 0x8848800200840080ULL, 0x4001000100040200ULL, 0x0442000102105084ULL,
+        0x9080010020804100ULL, 0x0040404000201009ULL, 0x0000808010002009ULL, 0x2200090021D00100ULL,
+        0x0008008008040080ULL, 0x0004004002010040ULL, 0x0011040008015042ULL, 0x00000A0001768104ULL,
+        0x0000800080204009ULL, 0x2010004140002001ULL, 0x9800200280100080ULL, 0x1000100080080080ULL,
+        0x0442000A00049020ULL, 0x2100040080020080ULL, 0x0800120400900148ULL, 0x0010040A00128541ULL,
+        0x2800804000800030ULL, 0x1010002000400041ULL, 0x4000200011004100ULL, 0x0610008410800800ULL,
+        0x0400802402800800ULL, 0xC100020080800400ULL, 0x0002000802000401ULL, 0x0182085882000401ULL,
+        0x0220204000808000ULL, 0x2860100040024022ULL, 0x0001002004110040ULL, 0x99101042000A0020ULL,
+        0x0004080004008080ULL, 0x0010040002008080ULL, 0x2012004881020004ULL, 0x8300842444820011ULL,
+        0x0088403882010200ULL, 0x0820400080210100ULL, 0x0110910040A00300ULL, 0x0801100280080480ULL,
+        0x0242009008200600ULL, 0x1002000489500200ULL, 0x0040800200010080ULL, 0x0091800041000080ULL,
+        0x0000209300488001ULL, 0x04C1002414824001ULL, 0x020020000B001041ULL, 0x7000100004200901ULL,
+        0x8002002004100802ULL, 0x30010002084C0007ULL, 0x0888221800813004ULL, 0x4000002840840112ULL
+    };
+
+    std::array<SliderEntry, 64> buildSliderEntries(const int (&directions)[4][2], const Bitboard (&magics)[64], Bitboard* attacks) {
+        std::array<SliderEntry, 64> entries = {};
+        for (int square = 0; square < 64; ++square) {
+            SliderEntry& entry = entries[square];
+            entry.mask = getRelevantMask(square, directions);
+            entry.magic = magics[square];
+            entry.shift = unsigned(64 - std::popcount(entry.mask));
+            entry.attacks = attacks;
+
+            // Carry-Rippler walk over every subset of the mask
+            Bitboard occupied = 0;
+            do {
+                attacks[entry.getIndex(occupied)] = getRayAttacks(square, occupied, directions);
+                occupied = (occupied - entry.mask) & entry.mask;
+            } while (occupied);
+
+            attacks += std::size_t(1) << std::popcount(entry.mask);
+        }
+        return entries;
+    }
+
+}
+
+namespace chess::model::attacks {
+
+    const std::array<SliderEntry, 64> BISHOP_ENTRIES = buildSliderEntries(BISHOP_DIRECTIONS, BISHOP_MAGICS, SLIDER_ATTACKS);
+    const std::array<SliderEntry, 64> ROOK_ENTRIES = buildSliderEntries(ROOK_DIRECTIONS, ROOK_MAGICS, SLIDER_ATTACKS + BISHOP_TABLE_SIZE);
+
+}
@@ -0,0 +1,125 @@
+// chess_attacks.h
+// by Jake Charles Osborne III
+#pragma once
+
+
+
+#include "chess_model.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+
+
+namespace chess::model::attacks {
+
+    template<std::size_t N>
+    constexpr Bitboard getLeaperAttacks(int square, const int (&offsets)[N][2]) {
+        Bitboard attacks = 0;
+        for (const auto& [dx, dy] : offsets) {
+            int x = square % 8 + dx;
+            int y = square / 8 + dy;
+            if (x >= 0 && x < 8 && y >= 0 && y < 8) attacks |= Bitboard(1) << (y * 8 + x);
+        }
+        return attacks;
+    }
+
+    inline constexpr int KNIGHT_OFFSETS[8][2] = { {1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2} };
+    inline constexpr int KING_OFFSETS[8][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
+    inline constexpr int WHITE_PAWN_OFFSETS[2][2] = { {-1, 1}, {1, 1} };
+    inline constexpr int BLACK_PAWN_OFFSETS[2][2] = { {-1, -1}, {1, -1} };
+
+    template<std::size_t N>
+    constexpr std::array<Bitboard, 64> buildLeaperTable(const int (&offsets)[N][2]) {
+        std::array<Bitboard, 64> table = {};
+        for (int square = 0; square < 64; ++square) table[square] = getLeaperAttacks(square, offsets);
+        return table;
+    }
+
+    inline constexpr std::array<Bitboard, 64> KNIGHT_ATTACKS = buildLeaperTable(KNIGHT_OFFSETS);
+    inline constexpr std::array<Bitboard, 64> KING_ATTACKS = buildLeaperTable(KING_OFFSETS);
+    inline constexpr std::array<Bitboard, 64> PAWN_ATTACKS[2] = { buildLeaperTable(WHITE_PAWN_OFFSETS), buildLeaperTable(BLACK_PAWN_OFFSETS) };
+
+    // for squares sharing a rank, file or diagonal: the squares strictly between them, or the whole line through
+    // both; empty for any other pair
+    constexpr std::array<std::array<Bitboard, 64>, 64> buildLineTable(bool between) {
+        std::array<std::array<Bitboard, 64>, 64> table = {};
+        const int directions[8][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
+        for (int from = 0; from < 64; ++from) {
+            for (const auto& [dx, dy] : directions) {
+                Bitboard line = Bitboard(1) << from;
+                for (int x = from % 8 + dx, y = from / 8 + dy; x >= 0 && x < 8 && y >= 0 && y < 8; x += dx, y += dy) line |= Bitboard(1) << (y * 8 + x);
+                for (int x = from % 8 - dx, y = from / 8 - dy; x >= 0 && x < 8 && y >= 0 && y < 8; x -= dx, y -= dy) line |= Bitboard(1) << (y * 8 + x);
+
+                Bitboard ray = 0;
+                for (int x = from % 8 + dx, y = from / 8 + dy; x >= 0 && x < 8 && y >= 0 && y < 8; x += dx, y += dy) {
+                    table[from][y * 8 + x] = between ? ray : line;
+                    ray |= Bitboard(1) << (y * 8 + x);
+                }
+            }
+        }
+        return table;
+    }
+
+    inline constexpr std::array<std::array<Bitboard, 64>, 64> BETWEEN_SQUARES = buildLineTable(true);
+    inline constexpr std::array<std::array<Bitboard, 64>, 64> LINE_THROUGH = buildLineTable(false);
+
+    // sliding attacks are read from a shared table at an index taken from the occupancy of the square's relevant
+    // rays: PEXT when the compiler targets BMI2, a magic multiply otherwise
+    struct SliderEntry
+    {
+        Bitboard mask; // relevant occupancy, not including the board edge at the end of each ray
+        Bitboard magic;
+        unsigned shift;
+        const Bitboard* attacks;
+
+        std::size_t getIndex(Bitboard occupied) const {
+#if defined(__BMI2__)
+            return _pext_u64(occupied, mask);
+#else
+            return ((occupied & mask) * magic) >> shift;
+#endif
+        }
+    };
+
+    // filled during static initialisation, so not for use from other static initialisers
+    extern const std::array<SliderEntry, 64> BISHOP_ENTRIES;
+    extern const std::array<SliderEntry, 64> ROOK_ENTRIES;
+
+    inline Bitboard getPawnAttacks(int square, Piece::Color color) { return PAWN_ATTACKS[static_cast<int>(color)][square]; }
+    inline Bitboard getKnightAttacks(int square) { return KNIGHT_ATTACKS[square]; }
+    inline Bitboard getKingAttacks(int square) { return KING_ATTACKS[square]; }
+
+    inline Bitboard getBishopAttacks(int square, Bitboard occupied) {
+        const SliderEntry& entry = BISHOP_ENTRIES[square];
+        return entry.attacks[entry.getIndex(occupied)];
+    }
+
+    inline Bitboard getRookAttacks(int square, Bitboard occupied) {
+        const SliderEntry& entry = ROOK_ENTRIES[square];
+        return entry.attacks[entry.getIndex(occupied)];
+    }
+
+    inline Bitboard getQueenAttacks(int square, Bitboard occupied) {
+        return getBishopAttacks(square, occupied) | getRookAttacks(square, occupied);
+    }
+
+    inline Bitboard getPieceAttacks(Piece::Type type, Piece::Color color, int square, Bitboard occupied) {
+        switch (type) {
+        case Piece::Type::pawn: return getPawnAttacks(square, color);
+        case Piece::Type::knight: return getKnightAttacks(square);
+        case Piece::Type::bishop: return getBishopAttacks(square, occupied);
+        case Piece::Type::rook: return getRookAttacks(square, occupied);
+        case Piece::Type::queen: return getQueenAttacks(square, occupied);
+        case Piece::Type::king: return getKingAttacks(square);
+        }
+        throw std::logic_error("unknown piece type");
+    }
+
+}
@@ -4,13 +4,23 @@
 
 
 #include "chess_model.h"
+#include "chess_attacks.h"
+#include "chess_piece_square_tables.h"
+#include "chess_zobrist_keys.h"
 
 #include <vector>
 #include <unordered_set>
 #include <tuple>
+#include <utility>
 #include <optional>
-#include <functional>
-#include <future>
+#include <bit>
+#include <algorithm>
+#include <cctype>
+#include <array>
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <stdexcept>
 
 using namespace chess::model;
 
@@ -19,47 +29,129 @@ using std::unordered_set;
 using std::tuple;
 using std::optional;
 using std::nullopt;
-using std::function;
-using std::future;
-using std::async;
 
 
 
-vector<Piece*> Piece::getPieces(const Board& board) { return board.pieces; }
+namespace {
 
+    enum CastlingRight : std::uint8_t {
+        whiteKingside = 1,
+        whiteQueenside = 2,
+        blackKingside = 4,
+        blackQueenside = 8
+    };
+
+    const std::size_t MAX_MOVES = 256; // no position has more than 218 legal moves
+
+    const char STARTING_FEN[] = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
 
-vector<vector<Move>> Piece::generateMovesWithPattern(const vector<Position>& pattern, const Board& board) {
-    vector<vector<Move>> result;
+    // indexed like the mailbox, by color * 6 + type
+    const std::string_view PIECE_LETTERS = "PNBRQKpnbrqk";
+    // indexed by CastlingRight bit
+    const std::string_view CASTLING_LETTERS = "KQkq";
+    const char FIELD_SEPARATORS[] = " \t\r\n";
+
+    constexpr int CASTLING_KEY_OFFSET = 768;
+    constexpr int EN_PASSANT_KEY_OFFSET = 772;
+    constexpr int TURN_KEY_INDEX = 780;
+
+    // piece is color * 6 + type; Polyglot orders kinds as black pawn, white pawn, black knight...
+    constexpr std::uint64_t pieceKey(std::uint8_t piece, int square) {
+        int kind = 2 * (piece % 6) + (piece / 6 == 0 ? 1 : 0);
+        return zobrist::KEYS[64 * kind + square];
+    }
 
-    for (Position nextPosition : pattern) {
-        optional<Color> heldBy = Position::heldBy(nextPosition, board);
-        if (Position::inBounds(nextPosition) && (!heldBy || heldBy.value() != color)) {
-            result.push_back( { Move(position, nextPosition) } );
+    constexpr std::uint64_t castlingKey(std::uint8_t castlingRights) {
+        std::uint64_t key = 0;
+        for (int right = 0; right < 4; ++right) {
+            if (castlingRights & (1 << right)) key ^= zobrist::KEYS[CASTLING_KEY_OFFSET + right];
         }
+        return key;
     }
 
-    return result;
-}
+    // Polyglot's published key for the starting position, checked against the table when this file is compiled
+    constexpr std::uint64_t startingPositionKey() {
+        constexpr std::uint8_t BACK_RANK[8] = { 3, 1, 2, 4, 5, 2, 1, 3 };
+        std::uint64_t key = castlingKey(whiteKingside | whiteQueenside | blackKingside | blackQueenside) ^ zobrist::KEYS[TURN_KEY_INDEX];
+        for (int file = 0; file < 8; ++file) {
+            key ^= pieceKey(BACK_RANK[file], file) ^ pieceKey(0, 8 + file);
+            key ^= pieceKey(6, 48 + file) ^ pieceKey(6 + BACK_RANK[file], 56 + file);
+        }
+        return key;
+    }
+    static_assert(startingPositionKey() == 0x463B96181691FC9CULL, "the Zobrist keys are not Polyglot's");
 
-vector<vector<Move>> Piece::generateMovesWithPattern(const vector<function<Position(Position) >> &pattern, const Board& board) {
-    vector<vector<Move>> result;
+    int indexOf(Piece::Color color) { return static_cast<int>(color); }
+    int indexOf(Piece::Type type) { return static_cast<int>(type); }
 
-    vector<Move> subset;
-    for (function f : pattern) {
-        Position nextPosition = f(position);
-        optional<Color> heldBy = Position::heldBy(nextPosition, board);
-        while (Position::inBounds(nextPosition) && (!heldBy || heldBy.value() != color)) {
-            subset.push_back(Move(position, nextPosition));
-            if (heldBy) break;
-            nextPosition = f(nextPosition);
-            heldBy = Position::heldBy(nextPosition, board);
-        }
+    Piece::Color opponentOf(Piece::Color color) {
+        return color == Piece::Color::white ? Piece::Color::black : Piece::Color::white;
+    }
 
-        result.push_back(subset);
-        subset.clear();
+    Bitboard squareBitboard(int square) { return Bitboard(1) << square; }
+
+    int popLeastSignificantSquare(Bitboard& bitboard) {
+        int square = std::countr_zero(bitboard);
+        bitboard &= bitboard - 1;
+        return square;
+    }
+
+    // the next field of text, which is advanced past it; empty once the text runs out
+    std::string_view nextField(std::string_view& text) {
+        std::size_t start = std::min(text.find_first_not_of(FIELD_SEPARATORS), text.size());
+        text.remove_prefix(start);
+        std::size_t end = std::min(text.find_first_of(FIELD_SEPARATORS), text.size());
+        std::string_view field = text.substr(0, end);
+        text.remove_prefix(end);
+        return field;
+    }
+
+    optional<unsigned> parseNumber(std::string_view field) {
+        unsigned number = 0;
+        auto [end, error] = std::from_chars(field.data(), field.data() + field.size(), number);
+        if (field.empty() || error != std::errc() || end != field.data() + field.size()) return nullopt;
+        return number;
+    }
+
+    // for checking a position before it is set up, from its bitboards alone
+    bool isSquareAttackedIn(const Bitboard (&pieces)[2][6], int square, Piece::Color attacker) {
+        const Bitboard* attackerPieces = pieces[indexOf(attacker)];
+        Bitboard occupied = 0;
+        for (const auto& colorPieces : pieces) {
+            for (Bitboard bitboard : colorPieces) occupied |= bitboard;
+        }
+        return (attacks::getPawnAttacks(square, opponentOf(attacker)) & attackerPieces[indexOf(Piece::Type::pawn)]) ||
+            (attacks::getKnightAttacks(square) & attackerPieces[indexOf(Piece::Type::knight)]) ||
+            (attacks::getKingAttacks(square) & attackerPieces[indexOf(Piece::Type::king)]) ||
+            (attacks::getBishopAttacks(square, occupied) & (attackerPieces[indexOf(Piece::Type::bishop)] | attackerPieces[indexOf(Piece::Type::queen)])) ||
+            (attacks::getRookAttacks(square, occupied) & (attackerPieces[indexOf(Piece::Type::rook)] | attackerPieces[indexOf(Piece::Type::queen)]));
+    }
+
+    // castling rights that survive a move touching the given square
+    std::uint8_t castlingMaskOf(int square) {
+        switch (square) {
+        case 0: return ~whiteQueenside & 0xF;
+        case 4: return ~(whiteKingside | whiteQueenside) & 0xF;
+        case 7: return ~whiteKingside & 0xF;
+        case 56: return ~blackQueenside & 0xF;
+        case 60: return ~(blackKingside | blackQueenside) & 0xF;
+        case 63: return ~blackKingside & 0xF;
+        default: return 0xF;
+        }
     }
 
-    return result;
+}
+
+char Piece::getNotation(Type type) {
+    switch (type) {
+    case Type::pawn: return 'P';
+    case Type::knight: return 'N';
+    case Type::bishop: return 'B';
+    case Type::rook: return 'R';
+    case Type::queen: return 'Q';
+    case Type::king: return 'K';
+    }
+    throw std::logic_error("unknown piece type");
 }
 
 Piece::Position::Position(char x, int y) {
@@ -75,6 +167,9 @@ Piece::Position::Position(int x, int y) {
 bool Piece::Position::operator ==(const Position& p) const { return this->x == p.x && this->y == p.y; }
 bool Piece::Position::operator !=(const Position& p) const { return !(*this == p); }
 
+int Piece::Position::toSquare() const { return (y - 1) * 8 + (x - 'A'); }
+Piece::Position Piece::Position::fromSquare(int square) { return Position(char('A' + square % 8), square / 8 + 1); }
+
 bool Piece::Position::sameCol(const Position& position1, const Position& position2) { return position1.x == position2.x; }
 bool Piece::Position::sameRow(const Position& position1, const Position& position2) { return position1.y == position2.y; }
 bool Piece::Position::sameMainDiagonal(const Position& position1, const Position& position2) { return position1.x + position1.y == position2.x + position2.y; }
@@ -82,615 +177,690 @@ bool Piece::Position::sameAntidiagonal(const Position& position1, const Position
 bool Piece::Position::inBounds(const Position& position) { return position.x >= 'A' && position.x <= ('A' - 1) + 8 && position.y >= 1 && position.y <= 8; }
 
 std::optional<Piece::Color> Piece::Position::heldBy(const Position& position, const Board& board) {
-    for (Piece* const& piece : board.pieces) {
-        if (piece && piece->position == position) {
-            return piece->color;
-        }
-    }
-    return nullopt;
+    if (!inBounds(position)) return nullopt;
+    std::uint8_t piece = board.mailbox[position.toSquare()];
+    if (piece == Board::EMPTY_SQUARE) return nullopt;
+    return static_cast<Color>(piece / 6);
 }
 
-Pawn::Pawn(Color color, Position position, bool firstMove, bool enPassantCapturable) {
-    this->color = color;
-    this->position = position;
-    this->firstMove = firstMove;
-    this->enPassantCapturable = enPassantCapturable;
-    updateEffect = [&]() { enPassantCapturable = false; };
-}
-
-Piece* Pawn::newCopy() const {
-    return new Pawn(color, position, enPassantCapturable);
-}
-
-vector<vector<Move>> Pawn::getMoves(const Board& board) {
-    vector<vector<Move>> moves;
-
-    Position forward;
-    Position doubleStep;
-    if (color == Color::white) {
-        forward = Position(position.x, position.y + 1);
-        doubleStep = Position(position.x, position.y + 2);
-    }
-    else if (color == Color::black) {
-        forward = Position(position.x, position.y - 1);
-        doubleStep = Position(position.x, position.y - 2);
-    }
-    else throw std::logic_error("nonstandard pawn color not implemented");
-
-    function<void()> pawnMoveEffect = [&]() { firstMove = false; };
-    if (Position::inBounds(forward) && !Position::inBounds(doubleStep)) {
-        pawnMoveEffect = [&]() {
-            Piece* promotion;
-            for (auto piece : getPieces(board)) {
-                if (this->position == piece->position) promotion = piece;
-            }
-            delete promotion;
-            promotion = new Queen(color, position);
-        };
-    }
+Move::Move(int fromSquare, int toSquare, Flag flag) : encoding(std::uint16_t(fromSquare | toSquare << 6 | flag << 12)) {}
+Move::Move(std::uint16_t encoding) : encoding(encoding) {}
 
-    if (!Position::heldBy(forward, board)) {
-        moves.push_back({ Move(position, forward, pawnMoveEffect) });
-    }
-    if (firstMove && !Position::heldBy(doubleStep, board)) {
-        moves.push_back({
-            Move(position, doubleStep, [&]() {
-                firstMove = false;
-                enPassantCapturable = true;
-            })
-        });
-    }
+bool Move::operator ==(const Move& m) const { return encoding == m.encoding; }
+bool Move::operator !=(const Move& m) const { return encoding != m.encoding; }
 
-    optional<Color> kingSideCapture = Position::heldBy(Position(forward.x + 1, forward.y), board);
-    if (kingSideCapture && kingSideCapture.value() != color) {
-        moves.push_back({ Move(position, Position(forward.x + 1, forward.y), pawnMoveEffect) });
-    }
-    optional<Color> queenSideCapture = Position::heldBy(Position(forward.x + 1, forward.y), board);
-    if (queenSideCapture && queenSideCapture.value() != color) {
-        moves.push_back({ Move(position, Position(forward.x + 1, forward.y), pawnMoveEffect) });
-    }
+Piece::Position Move::getFrom() const { return Piece::Position::fromSquare(getFromSquare()); }
+Piece::Position Move::getTo() const { return Piece::Position::fromSquare(getToSquare()); }
+int Move::getFromSquare() const { return encoding & 0x3F; }
+int Move::getToSquare() const { return encoding >> 6 & 0x3F; }
+Move::Flag Move::getFlag() const { return static_cast<Flag>(encoding >> 12); }
+std::uint16_t Move::getEncoding() const { return encoding; }
 
-    // En Passant capture
-    Piece* kingSideEnPassant = nullptr;
-    Piece* queenSideEnPassant = nullptr;
-    for (Piece* const& piece : getPieces(board)) {
-        if (piece->position == Position(position.x + 1, position.y)) kingSideEnPassant = piece;
-        if (piece->position == Position(position.x - 1, position.y)) queenSideEnPassant = piece;
-    }
-
-    bool kingSideEnPassantCaptureAvailable = kingSideEnPassant &&
-        kingSideEnPassant->color != color &&
-        kingSideEnPassant->getNotation() == 'P' &&
-        static_cast<Pawn*>(kingSideEnPassant)->enPassantCapturable;
-    if (kingSideEnPassantCaptureAvailable) {
-        moves.push_back({ Move(position, Position(forward.x + 1, forward.y), [&]() { delete kingSideEnPassant; }) });
-    }
+bool Move::isCapture() const { return getFlag() & capture; }
+bool Move::isPromotion() const { return getFlag() & knightPromotion; }
 
-    bool queenSideEnPassantCaptureAvailable = queenSideEnPassant &&
-        queenSideEnPassant->color == color &&
-        queenSideEnPassant->getNotation() == 'P' &&
-        static_cast<Pawn*>(queenSideEnPassant)->enPassantCapturable;
-    if (queenSideEnPassantCaptureAvailable) {
-        moves.push_back({ Move(position, Position(forward.x + 1, forward.y), [&]() { delete queenSideEnPassant; }) });
-    }
-
-    Piece* shortSidePiece = nullptr;
-    Piece* longSidePiece = nullptr;
-    for (Piece* const& piece : getPieces(board)) {
-        if (piece && Position::sameRow(piece->position, position)) {
-            if (piece->position.x > position.x && (!shortSidePiece || shortSidePiece->position.x < piece->position.x)) {
-                shortSidePiece = piece;
-            }
-            if (piece->position.x < position.x && (!longSidePiece || longSidePiece->position.x > piece->position.x)) {
-                longSidePiece = piece;
-            }
-        }
-    }
-    return moves;
+// the low two flag bits count up from knight, in the same order as Piece::Type
+optional<Piece::Type> Move::getPromotionType() const {
+    if (!isPromotion()) return nullopt;
+    return static_cast<Piece::Type>(indexOf(Piece::Type::knight) + (getFlag() & 3));
 }
 
-char Pawn::getNotation() const { return 'P'; }
+std::string Move::getCoordinateNotation() const {
+    std::string notation = {
+        char('a' + getFromSquare() % 8), char('1' + getFromSquare() / 8),
+        char('a' + getToSquare() % 8), char('1' + getToSquare() / 8)
+    };
+    if (auto promotionType = getPromotionType()) notation += char(std::tolower(Piece::getNotation(*promotionType)));
+    return notation;
+}
 
-Knight::Knight(Color color, Position position) {
-    this->color = color;
-    this->position = position;
+void Board::placePiece(Piece::Color color, Piece::Type type, int square) {
+    Bitboard bit = squareBitboard(square);
+    pieceBitboards[indexOf(color)][indexOf(type)] |= bit;
+    colorBitboards[indexOf(color)] |= bit;
+    mailbox[square] = std::uint8_t(indexOf(color) * 6 + indexOf(type));
+    hashKey ^= pieceKey(mailbox[square], square);
+    midgameScores[indexOf(color)] += pst::MIDGAME_SCORES[mailbox[square]][square];
+    endgameScores[indexOf(color)] += pst::ENDGAME_SCORES[mailbox[square]][square];
+    phase += pst::PHASE_WEIGHTS[indexOf(type)];
 }
 
-Piece* Knight::newCopy() const {
-    return new Knight(color, position);
+void Board::removePiece(int square) {
+    std::uint8_t piece = mailbox[square];
+    if (piece == EMPTY_SQUARE) return;
+    Bitboard bit = squareBitboard(square);
+    pieceBitboards[piece / 6][piece % 6] &= ~bit;
+    colorBitboards[piece / 6] &= ~bit;
+    mailbox[square] = EMPTY_SQUARE;
+    hashKey ^= pieceKey(piece, square);
+    midgameScores[piece / 6] -= pst::MIDGAME_SCORES[piece][square];
+    endgameScores[piece / 6] -= pst::ENDGAME_SCORES[piece][square];
+    phase -= pst::PHASE_WEIGHTS[piece % 6];
 }
 
-vector<vector<Move>> Knight::getMoves(const Board& board) {
-    char& x = position.x;
-    int& y = position.y;
-    return generateMovesWithPattern(
-        {
-            {x + 1, y + 2},
-            {x + 2, y + 1},
-            {x + 2, y - 1},
-            {x + 1, y - 2},
-            {x - 1, y - 2},
-            {x - 2, y - 1},
-            {x - 2, y + 1},
-            {x - 1, y + 2}
-        },
-        board);
+void Board::relocatePiece(int from, int to) {
+    std::uint8_t piece = mailbox[from];
+    Bitboard bits = squareBitboard(from) | squareBitboard(to);
+    pieceBitboards[piece / 6][piece % 6] ^= bits;
+    colorBitboards[piece / 6] ^= bits;
+    mailbox[to] = piece;
+    mailbox[from] = EMPTY_SQUARE;
+    hashKey ^= pieceKey(piece, from) ^ pieceKey(piece, to);
+    midgameScores[piece / 6] += pst::MIDGAME_SCORES[piece][to] - pst::MIDGAME_SCORES[piece][from];
+    endgameScores[piece / 6] += pst::ENDGAME_SCORES[piece][to] - pst::ENDGAME_SCORES[piece][from];
 }
 
-char Knight::getNotation() const { return 'N'; }
+void Board::applyMove(const Move& move) {
+    int from = move.getFromSquare();
+    int to = move.getToSquare();
+    int forward = currentTurn == Piece::Color::white ? 8 : -8;
 
-Bishop::Bishop(Color color, Position position) {
-    this->color = color;
-    this->position = position;
-}
+    hashKey ^= getEnPassantKey() ^ castlingKey(castlingRights);
 
-Piece* Bishop::newCopy() const {
-    return new Bishop(color, position);
-}
+    if (move.isCapture() || mailbox[from] % 6 == indexOf(Piece::Type::pawn)) halfmoveClock = 0;
+    else ++halfmoveClock;
+    if (currentTurn == Piece::Color::black) ++fullmoveNumber;
 
-vector<vector<Move>> Bishop::getMoves(const Board& board) {
-    return generateMovesWithPattern(
-        {
-            [&](Position p) { return Position(p.x + 1, p.y + 1); },
-            [&](Position p) { return Position(p.x + 1, p.y - 1); },
-            [&](Position p) { return Position(p.x - 1, p.y + 1); },
-            [&](Position p) { return Position(p.x - 1, p.y - 1); }
-        },
-        board);
-}
+    if (move.getFlag() == Move::enPassantCapture) removePiece(to - forward);
+    else if (move.isCapture()) removePiece(to);
+    relocatePiece(from, to);
 
-char Bishop::getNotation() const { return 'B'; }
+    if (auto promotionType = move.getPromotionType()) {
+        removePiece(to);
+        placePiece(currentTurn, *promotionType, to);
+    }
+    else if (move.getFlag() == Move::kingsideCastle) relocatePiece(from + 3, from + 1);
+    else if (move.getFlag() == Move::queensideCastle) relocatePiece(from - 4, from - 1);
 
-Rook::Rook(Color color, Position position, bool canCastle) {
-    this->color = color;
-    this->position = position;
-    this->canCastle = canCastle;
-}
+    enPassantSquare = nullopt;
+    if (move.getFlag() == Move::doublePawnPush) enPassantSquare = from + forward;
 
-Piece* Rook::newCopy() const {
-    return new Rook(color, position, canCastle);
-}
+    castlingRights &= castlingMaskOf(from) & castlingMaskOf(to);
+    currentTurn = opponentOf(currentTurn);
 
-vector<vector<Move>> Rook::getMoves(const Board& board) {
-    auto moves = generateMovesWithPattern(
-        {
-            [&](Position p) { return Position(p.x + 1, p.y); },
-            [&](Position p) { return Position(p.x - 1, p.y); },
-            [&](Position p) { return Position(p.x, p.y + 1); },
-            [&](Position p) { return Position(p.x, p.y - 1); }
-        },
-        board);
+    hashKey ^= zobrist::KEYS[TURN_KEY_INDEX] ^ castlingKey(castlingRights) ^ getEnPassantKey();
+    updateCheckInfo();
+}
 
-    function<void()> rookMoveEffect = [&]() { canCastle = false; };
-    for (vector<Move>& subset : moves) {
-        for (Move& move : subset) {
-            move.effect = rookMoveEffect;
-        }
+// as in Polyglot, the en passant file only counts when the side to move has a pawn able to capture
+std::uint64_t Board::getEnPassantKey() const {
+    if (!enPassantSquare) return 0;
+    Bitboard capturingPawns = pieceBitboards[indexOf(currentTurn)][indexOf(Piece::Type::pawn)];
+    if (!(attacks::getPawnAttacks(*enPassantSquare, opponentOf(currentTurn)) & capturingPawns)) return 0;
+    return zobrist::KEYS[EN_PASSANT_KEY_OFFSET + *enPassantSquare % 8];
+}
+
+std::uint64_t Board::computeHashKey() const {
+    std::uint64_t key = castlingKey(castlingRights) ^ getEnPassantKey();
+    if (currentTurn == Piece::Color::white) key ^= zobrist::KEYS[TURN_KEY_INDEX];
+    for (int square = 0; square < 64; ++square) {
+        if (mailbox[square] != EMPTY_SQUARE) key ^= pieceKey(mailbox[square], square);
+    }
+    return key;
+}
+
+// everything legality needs to know about the side to move, refreshed after each move and restored on unmake
+void Board::updateCheckInfo() {
+    Piece::Color enemyColor = opponentOf(currentTurn);
+    Bitboard king = pieceBitboards[indexOf(currentTurn)][indexOf(Piece::Type::king)];
+    Bitboard occupied = colorBitboards[0] | colorBitboards[1];
+
+    // sliders keep attacking the squares behind a king that steps away from them
+    threatenedSquares = getAttackedSquares(enemyColor, occupied & ~king);
+    checkers = 0;
+    pinnedPieces = 0;
+    if (!king) return;
+
+    int kingSquare = std::countr_zero(king);
+    checkers = getAttackersOf(kingSquare, occupied) & colorBitboards[indexOf(enemyColor)];
+
+    const Bitboard* enemyPieces = pieceBitboards[indexOf(enemyColor)];
+    Bitboard snipers =
+        (attacks::getBishopAttacks(kingSquare, 0) & (enemyPieces[indexOf(Piece::Type::bishop)] | enemyPieces[indexOf(Piece::Type::queen)])) |
+        (attacks::getRookAttacks(kingSquare, 0) & (enemyPieces[indexOf(Piece::Type::rook)] | enemyPieces[indexOf(Piece::Type::queen)]));
+    while (snipers) {
+        Bitboard blockers = attacks::BETWEEN_SQUARES[kingSquare][popLeastSignificantSquare(snipers)] & occupied;
+        if (std::has_single_bit(blockers) && (blockers & colorBitboards[indexOf(currentTurn)])) pinnedPieces |= blockers;
     }
+}
 
-    return moves;
+Bitboard Board::getAttackedSquares(Piece::Color attacker, Bitboard occupied) const {
+    Bitboard attackedSquares = 0;
+    Bitboard pieces = colorBitboards[indexOf(attacker)];
+    while (pieces) {
+        int square = popLeastSignificantSquare(pieces);
+        attackedSquares |= attacks::getPieceAttacks(static_cast<Piece::Type>(mailbox[square] % 6), attacker, square, occupied);
+    }
+    return attackedSquares;
 }
 
-char Rook::getNotation() const { return 'R'; }
+Bitboard Board::getAttackersOf(int square, Bitboard occupied) const {
+    const Bitboard* white = pieceBitboards[indexOf(Piece::Color::white)];
+    const Bitboard* black = pieceBitboards[indexOf(Piece::Color::black)];
+    Bitboard diagonalSliders = white[indexOf(Piece::Type::bishop)] | white[indexOf(Piece::Type::queen)] |
+        black[indexOf(Piece::Type::bishop)] | black[indexOf(Piece::Type::queen)];
+    Bitboard orthogonalSliders = white[indexOf(Piece::Type::rook)] | white[indexOf(Piece::Type::queen)] |
+        black[indexOf(Piece::Type::rook)] | black[indexOf(Piece::Type::queen)];
 
-Queen::Queen(Color color, Position position) {
-    this->color = color;
-    this->position = position;
+    return (attacks::getPawnAttacks(square, Piece::Color::black) & white[indexOf(Piece::Type::pawn)]) |
+        (attacks::getPawnAttacks(square, Piece::Color::white) & black[indexOf(Piece::Type::pawn)]) |
+        (attacks::getKnightAttacks(square) & (white[indexOf(Piece::Type::knight)] | black[indexOf(Piece::Type::knight)])) |
+        (attacks::getKingAttacks(square) & (white[indexOf(Piece::Type::king)] | black[indexOf(Piece::Type::king)])) |
+        (attacks::getBishopAttacks(square, occupied) & diagonalSliders) |
+        (attacks::getRookAttacks(square, occupied) & orthogonalSliders);
 }
 
-Piece* Queen::newCopy() const {
-    return new Queen(color, position);
+bool Board::isSquareAttacked(int square, Piece::Color attacker) const {
+    return getAttackersOf(square, colorBitboards[0] | colorBitboards[1]) & colorBitboards[indexOf(attacker)];
 }
 
-vector<vector<Move>> Queen::getMoves(const Board& board) {
-    return generateMovesWithPattern(
-        {
-            [&](Position p) { return Position(p.x + 1, p.y); },
-            [&](Position p) { return Position(p.x - 1, p.y); },
-            [&](Position p) { return Position(p.x, p.y + 1); },
-            [&](Position p) { return Position(p.x, p.y - 1); },
+// en passant empties two squares on one rank, so the king is tested against the occupancy left behind
+bool Board::isLegalEnPassant(int from) const {
+    Bitboard king = pieceBitboards[indexOf(currentTurn)][indexOf(Piece::Type::king)];
+    if (!king) return true;
 
-            [&](Position p) { return Position(p.x + 1, p.y + 1); },
-            [&](Position p) { return Position(p.x + 1, p.y - 1); },
-            [&](Position p) { return Position(p.x - 1, p.y + 1); },
-            [&](Position p) { return Position(p.x - 1, p.y - 1); },
-        },
-        board);
+    int to = *enPassantSquare;
+    int capturedSquare = to + (currentTurn == Piece::Color::white ? -8 : 8);
+    Bitboard occupied = ((colorBitboards[0] | colorBitboards[1]) ^ squareBitboard(from) ^ squareBitboard(capturedSquare)) | squareBitboard(to);
+    Bitboard enemy = colorBitboards[indexOf(opponentOf(currentTurn))] & ~squareBitboard(capturedSquare);
+    return !(getAttackersOf(std::countr_zero(king), occupied) & enemy);
 }
 
-char Queen::getNotation() const { return 'Q'; }
-
-King::King(Color color, Position position, bool canCastle) {
-    this->color = color;
-    this->position = position;
-    this->canCastle = canCastle;
+// in check, pieces other than the king must capture the checker or block; in double check only the king can move
+Bitboard Board::getCheckTargetMask() const {
+    if (!checkers) return ~Bitboard(0);
+    int kingSquare = std::countr_zero(pieceBitboards[indexOf(currentTurn)][indexOf(Piece::Type::king)]);
+    return std::has_single_bit(checkers) ? checkers | attacks::BETWEEN_SQUARES[kingSquare][std::countr_zero(checkers)] : 0;
 }
 
-Piece* King::newCopy() const {
-    return new King(color, position, canCastle);
-}
+// targetMask holds the squares that answer any check; pins narrow it further for the piece itself
+void Board::appendLegalMoves(int square, Bitboard targetMask, vector<Move>& moves) const {
+    Piece::Color color = currentTurn;
+    Piece::Type type = static_cast<Piece::Type>(mailbox[square] % 6);
+    Bitboard own = colorBitboards[indexOf(color)];
+    Bitboard enemy = colorBitboards[indexOf(opponentOf(color))];
+    Bitboard occupied = own | enemy;
 
-vector<vector<Move>> King::getMoves(const Board& board) {
-    char& x = position.x;
-    int& y = position.y;
-    auto moves = generateMovesWithPattern(
-        {
-            {x + 1, y},
-            {x - 1, y},
-            {x, y + 1},
-            {x, y - 1},
+    if (type == Piece::Type::king) {
+        Bitboard targets = attacks::getKingAttacks(square) & ~own & ~threatenedSquares;
+        while (targets) {
+            int to = popLeastSignificantSquare(targets);
+            moves.push_back(Move(square, to, (enemy & squareBitboard(to)) ? Move::capture : Move::quiet));
+        }
+
+        // Castling
+        int homeSquare = color == Piece::Color::white ? 4 : 60;
+        std::uint8_t kingside = color == Piece::Color::white ? whiteKingside : blackKingside;
+        std::uint8_t queenside = color == Piece::Color::white ? whiteQueenside : blackQueenside;
 
-            {x + 1, y + 1},
-            {x + 1, y - 1},
-            {x - 1, y + 1},
-            {x - 1, y - 1}
-        },
-        board);
+        if (square == homeSquare && !checkers) {
+            Bitboard kingsidePath = squareBitboard(square + 1) | squareBitboard(square + 2);
+            bool kingsidePathClear = !(occupied & kingsidePath) && !(threatenedSquares & kingsidePath);
+            if ((castlingRights & kingside) && kingsidePathClear) {
+                moves.push_back(Move(square, square + 2, Move::kingsideCastle));
+            }
 
-    function<void()> kingMoveEffect = [&]() { canCastle = false; };
-    for (vector<Move>& subset : moves) {
-        for (Move& move : subset) {
-            move.effect = kingMoveEffect;
+            Bitboard queensidePath = squareBitboard(square - 1) | squareBitboard(square - 2);
+            bool queensidePathClear = !(occupied & (queensidePath | squareBitboard(square - 3))) && !(threatenedSquares & queensidePath);
+            if ((castlingRights & queenside) && queensidePathClear) {
+                moves.push_back(Move(square, square - 2, Move::queensideCastle));
+            }
         }
+        return;
     }
 
-    // Castling
-    if (canCastle) {
-        bool underAttack = false;
-        bool shortPathClear = true;
-        bool longPathClear = true;
-        unordered_set<Position> positionsUnderAttack = board.getPositionsUnderAttack();
-        if (positionsUnderAttack.find(this->position) != positionsUnderAttack.end()) underAttack = true;
-        if (positionsUnderAttack.find(Position(x - 1, y)) != positionsUnderAttack.end() ||
-            positionsUnderAttack.find(Position(x - 2, y)) != positionsUnderAttack.end()) shortPathClear = false;
-        if (positionsUnderAttack.find(Position(x + 1, y)) != positionsUnderAttack.end() ||
-            positionsUnderAttack.find(Position(x + 2, y)) != positionsUnderAttack.end()) longPathClear = false;
-
-        Piece* shortSidePiece = nullptr;
-        Piece* longSidePiece = nullptr;
-        for (Piece* const& piece : getPieces(board)) {
-            if (piece && Position::sameRow(piece->position, position)) {
-                if (piece->position.x > position.x && (!shortSidePiece || shortSidePiece->position.x < piece->position.x)) {
-                    shortSidePiece = piece;
-                }
-                if (piece->position.x < position.x && (!longSidePiece || longSidePiece->position.x > piece->position.x)) {
-                    longSidePiece = piece;
-                }
+    if (pinnedPieces & squareBitboard(square)) {
+        int kingSquare = std::countr_zero(pieceBitboards[indexOf(color)][indexOf(Piece::Type::king)]);
+        targetMask &= attacks::LINE_THROUGH[kingSquare][square];
+    }
+
+    if (type == Piece::Type::pawn) {
+        int forward = color == Piece::Color::white ? 8 : -8;
+        int startRank = color == Piece::Color::white ? 1 : 6;
+        int promotionRank = color == Piece::Color::white ? 7 : 0;
+
+        Bitboard targets = attacks::getPawnAttacks(square, color) & enemy;
+        if (!(occupied & squareBitboard(square + forward))) {
+            targets |= squareBitboard(square + forward);
+            int doublePushSquare = square + 2 * forward;
+            if (square / 8 == startRank && !(occupied & squareBitboard(doublePushSquare)) && (targetMask & squareBitboard(doublePushSquare))) {
+                moves.push_back(Move(square, doublePushSquare, Move::doublePawnPush));
             }
         }
 
-        // corner cases for customized boards
-        if (!Position::inBounds(Position(x - 1, y)) || !Position::inBounds(Position(x - 2, y))) shortPathClear = false;
-        if (!Position::inBounds(Position(x + 1, y)) || !Position::inBounds(Position(x + 2, y))) longPathClear = false;
-        if (shortSidePiece->position.x == position.x - 1) {
-            optional<Color> heldBy = Position::heldBy(Position(position.x - 2, position.y), board);
-            if (heldBy && heldBy.value() == color) {
-                shortPathClear = false;
+        targets &= targetMask;
+        while (targets) {
+            int to = popLeastSignificantSquare(targets);
+            int captureFlag = (enemy & squareBitboard(to)) ? Move::capture : Move::quiet;
+            if (to / 8 == promotionRank) {
+                // queen first, so callers picking the first match promote to a queen
+                for (Move::Flag promotion : { Move::queenPromotion, Move::rookPromotion, Move::bishopPromotion, Move::knightPromotion }) {
+                    moves.push_back(Move(square, to, static_cast<Move::Flag>(promotion | captureFlag)));
+                }
             }
-        }
-        if (longSidePiece->position.x == position.x + 1) {
-            optional<Color> heldBy = Position::heldBy(Position(position.x + 2, position.y), board);
-            if (heldBy && heldBy.value() == color) {
-                longPathClear = false;
+            else {
+                moves.push_back(Move(square, to, static_cast<Move::Flag>(captureFlag)));
             }
         }
 
-        bool shortSidePieceCanCastle = shortSidePiece &&
-            shortSidePiece->color == color &&
-            shortSidePiece->getNotation() == 'R' &&
-            static_cast<Rook*>(shortSidePiece)->canCastle;
-        if (!underAttack && shortPathClear && shortSidePieceCanCastle) {
-            Move shortCastle = Move(position, Position(char(position.x - 2), position.y), [&]() {
-                canCastle = false;
-                shortSidePiece->position.x = x - 1;
-                static_cast<Rook*>(shortSidePiece)->canCastle = false;
-            });
-            moves.push_back({ shortCastle });
-        }
-
-        bool longSidePieceCanCastle = longSidePiece &&
-            longSidePiece->color == color &&
-            longSidePiece->getNotation() == 'R' && 
-            static_cast<Rook*>(longSidePiece)->canCastle;
-        if (!underAttack && longPathClear && longSidePieceCanCastle) {
-            Move longCastle = Move(position, Position(char(position.x + 2), position.y), [&]() {
-                canCastle = false;
-                longSidePiece->position.x = x + 1;
-                static_cast<Rook*>(longSidePiece)->canCastle = false;
-            });
-            moves.push_back({ longCastle });
+        // En Passant capture
+        if (enPassantSquare && (attacks::getPawnAttacks(square, color) & squareBitboard(*enPassantSquare)) && isLegalEnPassant(square)) {
+            moves.push_back(Move(square, *enPassantSquare, Move::enPassantCapture));
         }
+        return;
     }
 
-    return moves;
-}
-
-char King::getNotation() const { return 'K'; }
-
-Move::Move(Piece::Position from, Piece::Position to, optional<function<void()>> effect) {
-    this->from = from;
-    this->to = to;
-    this->effect = effect;
+    Bitboard targets = attacks::getPieceAttacks(type, color, square, occupied) & ~own & targetMask;
+    while (targets) {
+        int to = popLeastSignificantSquare(targets);
+        moves.push_back(Move(square, to, (enemy & squareBitboard(to)) ? Move::capture : Move::quiet));
+    }
 }
 
-void Board::advanceTurn(vector<Piece::Color>::const_iterator& i) const {
-    ++i;
-    if (i == turnOrder.end()) {
-        i = turnOrder.begin();
-    }
+Board::Board() {
+    setDefaultGame();
 }
 
-optional<Piece::Position> Board::getPieceToCapturePosition(Piece::Color color) const {
-    for (auto piece : pieces) {
-        if (piece && piece->color == color && piece->getNotation() == pieceTypeToCapture) {
-            return piece->position;
+void Board::setDefaultGame() {
+    setFEN(STARTING_FEN);
+}
+
+// everything is parsed and checked into locals first, so a bad position never touches the board
+void Board::setFEN(std::string_view fen) {
+    std::array<std::uint8_t, 64> squares;
+    squares.fill(EMPTY_SQUARE);
+    Bitboard pieces[2][6] = {};
+
+    int rank = 7;
+    int file = 0;
+    for (char c : nextField(fen)) {
+        if (c == '/') {
+            if (file != 8 || rank == 0) throw std::invalid_argument("FEN ranks must each cover eight squares");
+            --rank;
+            file = 0;
+        }
+        else if (c >= '1' && c <= '8') {
+            file += c - '0';
+            if (file > 8) throw std::invalid_argument("FEN ranks must each cover eight squares");
+        }
+        else {
+            std::size_t piece = PIECE_LETTERS.find(c);
+            if (piece == std::string_view::npos) throw std::invalid_argument("unknown piece letter in FEN");
+            if (file == 8) throw std::invalid_argument("FEN ranks must each cover eight squares");
+            int square = rank * 8 + file++;
+            squares[square] = std::uint8_t(piece);
+            pieces[piece / 6][piece % 6] |= squareBitboard(square);
         }
     }
-    return nullopt;
-}
-
-optional<unordered_set<Piece::Position>> Board::getPositionsBlockingCheck() const {
-    optional<unordered_set<Piece::Position>> positionsBlockingCheck = nullopt;
+    if (rank != 0 || file != 8) throw std::invalid_argument("FEN must describe eight ranks of eight squares");
 
-    optional<Piece::Position> pieceToCapturePosition = getPieceToCapturePosition(getCurrentTurn());
-    if (!pieceToCapturePosition) return nullopt;
-    for (auto piece : pieces) {
-        if (piece && piece->color != getCurrentTurn()) {
-            auto movePatterns = piece->getMoves(*this);
-            for (auto movePattern : movePatterns) {
-                for (auto move : movePattern) {
-                    if (move.to == pieceToCapturePosition) {
-                        if (!positionsBlockingCheck) {
-                            for (auto move : movePattern) positionsBlockingCheck.emplace(move.to);
-                        }
-                        else {
-                            unordered_set<Piece::Position> newPositionsBlockingCheck;
-                            for (auto move : movePattern) {
-                                if (positionsBlockingCheck->find(move.to) != positionsBlockingCheck->end()) {
-                                    newPositionsBlockingCheck.emplace(move.to);
-                                }
-                            }
-                            positionsBlockingCheck = newPositionsBlockingCheck;
-                        }
+    const Bitboard FIRST_AND_LAST_RANKS = 0xFF000000000000FFULL;
+    for (const auto& colorPieces : pieces) {
+        if (!std::has_single_bit(colorPieces[indexOf(Piece::Type::king)])) throw std::invalid_argument("each side needs exactly one king");
+        if (colorPieces[indexOf(Piece::Type::pawn)] & FIRST_AND_LAST_RANKS) throw std::invalid_argument("pawns cannot stand on the first or last rank");
+    }
 
-                        positionsBlockingCheck.emplace(move.to);
-                        // overlap movePattern with existing positionsBlockingCheck
+    std::string_view turnField = nextField(fen);
+    if (turnField != "w" && turnField != "b") throw std::invalid_argument("FEN side to move must be w or b");
+    Piece::Color turn = turnField == "w" ? Piece::Color::white : Piece::Color::black;
 
+    std::uint8_t rights = 0;
+    std::string_view castlingField = nextField(fen);
+    if (castlingField.empty()) throw std::invalid_argument("FEN is missing its castling rights");
+    if (castlingField != "-") {
+        for (char c : castlingField) {
+            std::size_t right = CASTLING_LETTERS.find(c);
+            if (right == std::string_view::npos) throw std::invalid_argument("FEN castling rights must be - or some of KQkq");
+            rights |= std::uint8_t(1 << right);
+        }
+    }
+    // a right needs its king and rook still on their starting squares
+    for (int right = 0; right < 4; ++right) {
+        if (!(rights & (1 << right))) continue;
+        int color = right / 2;
+        int kingSquare = color == 0 ? 4 : 60;
+        int rookSquare = right % 2 == 0 ? kingSquare + 3 : kingSquare - 4;
+        if (!(pieces[color][indexOf(Piece::Type::king)] & squareBitboard(kingSquare)) ||
+            !(pieces[color][indexOf(Piece::Type::rook)] & squareBitboard(rookSquare))) throw std::invalid_argument("FEN castling right without its king and rook at home");
+    }
+
+    // the square passed over by a pawn that has just moved two squares, which must still stand in front of it
+    optional<int> passedSquare;
+    std::string_view enPassantField = nextField(fen);
+    if (enPassantField != "-") {
+        char passedRank = turn == Piece::Color::white ? '6' : '3';
+        if (enPassantField.size() != 2 || enPassantField[0] < 'a' || enPassantField[0] > 'h' || enPassantField[1] != passedRank) {
+            throw std::invalid_argument("FEN en passant square must be - or on the rank behind a pawn that has just moved two squares");
+        }
+        int square = (enPassantField[1] - '1') * 8 + (enPassantField[0] - 'a');
+        int forward = turn == Piece::Color::white ? 8 : -8;
+        if (!(pieces[indexOf(opponentOf(turn))][indexOf(Piece::Type::pawn)] & squareBitboard(square - forward)) ||
+            squares[square] != EMPTY_SQUARE || squares[square + forward] != EMPTY_SQUARE) {
+            throw std::invalid_argument("FEN en passant square without a pawn that has just moved two squares");
+        }
+        passedSquare = square;
+    }
 
+    unsigned halfmoves = 0;
+    unsigned fullmoves = 1;
+    if (std::string_view halfmoveField = nextField(fen); !halfmoveField.empty()) {
+        auto halfmoveNumber = parseNumber(halfmoveField);
+        auto fullmoveNumberField = parseNumber(nextField(fen));
+        if (!halfmoveNumber || !fullmoveNumberField || *halfmoveNumber > UINT16_MAX || *fullmoveNumberField < 1 || *fullmoveNumberField > UINT16_MAX) {
+            throw std::invalid_argument("FEN move clocks must be a halfmove count and a fullmove number from 1");
+        }
+        halfmoves = *halfmoveNumber;
+        fullmoves = *fullmoveNumberField;
+    }
+    if (!nextField(fen).empty()) throw std::invalid_argument("unexpected text after FEN");
+
+    int waitingKing = std::countr_zero(pieces[indexOf(opponentOf(turn))][indexOf(Piece::Type::king)]);
+    if (isSquareAttackedIn(pieces, waitingKing, turn)) throw std::invalid_argument("FEN side not to move is in check");
+
+    for (auto& colorPieces : pieceBitboards) {
+        for (Bitboard& bitboard : colorPieces) bitboard = 0;
+    }
+    colorBitboards[0] = colorBitboards[1] = 0;
+    mailbox.fill(EMPTY_SQUARE);
+    hashKey = 0;
+    midgameScores[0] = midgameScores[1] = 0;
+    endgameScores[0] = endgameScores[1] = 0;
+    phase = 0;
+    for (int square = 0; square < 64; ++square) {
+        if (squares[square] != EMPTY_SQUARE) placePiece(static_cast<Piece::Color>(squares[square] / 6), static_cast<Piece::Type>(squares[square] % 6), square);
+    }
+
+    castlingRights = rights;
+    enPassantSquare = passedSquare;
+    currentTurn = turn;
+    halfmoveClock = std::uint16_t(halfmoves);
+    fullmoveNumber = std::uint16_t(fullmoves);
+    hashKey = computeHashKey();
+    updateCheckInfo();
+}
+
+Board Board::fromFEN(std::string_view fen) {
+    Board board;
+    board.setFEN(fen);
+    return board;
+}
+
+std::string Board::toFEN() const {
+    std::string fen;
+    fen.reserve(96);
+    for (int rank = 7; rank >= 0; --rank) {
+        int emptySquares = 0;
+        for (int file = 0; file < 8; ++file) {
+            std::uint8_t piece = mailbox[rank * 8 + file];
+            if (piece == EMPTY_SQUARE) {
+                ++emptySquares;
+                continue;
+            }
+            if (emptySquares) fen += char('0' + emptySquares);
+            emptySquares = 0;
+            fen += PIECE_LETTERS[piece];
+        }
+        if (emptySquares) fen += char('0' + emptySquares);
+        if (rank) fen += '/';
+    }
 
-                    }
+    fen += currentTurn == Piece::Color::white ? " w " : " b ";
+    for (int right = 0; right < 4; ++right) {
+        if (castlingRights & (1 << right)) fen += CASTLING_LETTERS[right];
+    }
+    if (!castlingRights) fen += '-';
+    fen += ' ';
+    if (enPassantSquare) fen += { char('a' + *enPassantSquare % 8), char('1' + *enPassantSquare / 8) };
+    else fen += '-';
+    fen += ' ' + std::to_string(halfmoveClock) + ' ' + std::to_string(fullmoveNumber);
+    return fen;
+}
 
-                }
-            }
+vector<tuple<char, Piece::Color, Piece::Position>> Board::getPieces() const {
+    vector<tuple<char, Piece::Color, Piece::Position>> result;
+    for (int square = 0; square < 64; ++square) {
+        if (mailbox[square] != EMPTY_SQUARE) {
+            tuple<char, Piece::Color, Piece::Position> pieceData;
+            pieceData = {
+                Piece::getNotation(static_cast<Piece::Type>(mailbox[square] % 6)),
+                static_cast<Piece::Color>(mailbox[square] / 6),
+                Piece::Position::fromSquare(square)
+            };
+            result.push_back(pieceData);
         }
     }
+    return result;
+}
 
-    return positionsBlockingCheck;
+Piece::Color Board::getCurrentTurn() const {
+    return currentTurn;
 }
 
-void Board::updateAvailableMoves() {
-    availableMoves.clear();
+optional<Move> Board::parseSAN(std::string_view san) const {
+    while (!san.empty() && std::string_view("+#!?").find(san.back()) != std::string_view::npos) san.remove_suffix(1);
 
-    if (!winByCheckmate) { // checks and pins disabled for boards with an atypical player count, turn order, move generation etc.
-        vector<future<vector<vector<Move>>>> futures;
-        for (auto piece : pieces) {
-            if (piece && piece->color == getCurrentTurn()) {
-                futures.push_back(async(std::launch::async, [this, &piece]() {
-                    return piece->getMoves(*this); }));
-            }
-        }
-        for (auto& future : futures) {
-            auto movePatterns = future.get();
-            for (auto movePattern : movePatterns) {
-                availableMoves.insert(availableMoves.end(), movePattern.begin(), movePattern.end());
-            }
+    // only the moves of the pieces san could name are generated, into a buffer each thread keeps for reuse
+    thread_local vector<Move> candidates;
+    candidates.clear();
+
+    if (san == "O-O" || san == "0-0" || san == "O-O-O" || san == "0-0-0") {
+        Move::Flag flag = san.size() == 3 ? Move::kingsideCastle : Move::queensideCastle;
+        appendLegalMoves(std::countr_zero(pieceBitboards[indexOf(currentTurn)][indexOf(Piece::Type::king)]), getCheckTargetMask(), candidates);
+        for (const Move& move : candidates) {
+            if (move.getFlag() == flag) return move;
         }
-        // TODO: implement variable determining winner and assign to it here if it is determined to be more compatible with 3+ player games
-        return;
+        return nullopt;
     }
 
-    vector<future<vector<Move>>> futures;
-    optional<unordered_set<Piece::Position>> positionsBlockingCheck = getPositionsBlockingCheck();
-    for (auto piece : pieces) {
-        if (piece && piece->color == getCurrentTurn()) {
-            futures.push_back(async(std::launch::async, [this, &piece, &positionsBlockingCheck]() {
-                return this->getValidMoves(piece, positionsBlockingCheck); }));
-        }
+    Piece::Type type = Piece::Type::pawn;
+    if (!san.empty() && PIECE_LETTERS.substr(0, 6).find(san[0]) != std::string_view::npos) {
+        type = static_cast<Piece::Type>(PIECE_LETTERS.find(san[0]));
+        san.remove_prefix(1);
     }
-    for (auto& future : futures) {
-        auto validMoves = future.get();
-        availableMoves.insert(availableMoves.end(), validMoves.begin(), validMoves.end());
+
+    // a pawn move otherwise ends in its rank, so a trailing letter names the promotion, in either case
+    optional<Piece::Type> promotionType;
+    if (type == Piece::Type::pawn && !san.empty() && std::isalpha(static_cast<unsigned char>(san.back()))) {
+        std::size_t letter = PIECE_LETTERS.substr(1, 4).find(char(std::toupper(static_cast<unsigned char>(san.back()))));
+        if (letter == std::string_view::npos) return nullopt;
+        promotionType = static_cast<Piece::Type>(letter + 1);
+        san.remove_suffix(1);
+        if (!san.empty() && san.back() == '=') san.remove_suffix(1);
     }
-    // TODO: implement variable determining winner and assign to it here if it is determined to be more compatible with 3+ player games
-}
 
-vector<Move> Board::getValidMoves(Piece*& piece, const optional<unordered_set<Piece::Position>>& positionsBlockingCheck) const {
-    vector<Move> moves;
-    for (auto patterns : piece->getMoves(*this)) moves.insert(moves.end(), patterns.begin(), patterns.end());
-
-    auto pieceToCapturePosition = getPieceToCapturePosition(getCurrentTurn());
-    if (pieceToCapturePosition && *pieceToCapturePosition == piece->position) {
-        auto enemyAttacks = getPositionsUnderAttack();
-        vector<Move> safeMoves;
-        for (auto move : moves) {
-            if (enemyAttacks.find(move.to) == enemyAttacks.end()) {
-                safeMoves.push_back(move);
-            }
-        }
-        return safeMoves;
+    if (san.size() < 2 || san[san.size() - 2] < 'a' || san[san.size() - 2] > 'h' || san.back() < '1' || san.back() > '8') return nullopt;
+    int to = (san.back() - '1') * 8 + (san[san.size() - 2] - 'a');
+    san.remove_suffix(2);
+    if (!san.empty() && (san.back() == 'x' || san.back() == ':')) san.remove_suffix(1);
+
+    // what is left says which file, rank or square the piece came from
+    int fromFile = -1;
+    int fromRank = -1;
+    for (char c : san) {
+        if (c >= 'a' && c <= 'h') fromFile = c - 'a';
+        else if (c >= '1' && c <= '8') fromRank = c - '1';
+        else return nullopt;
     }
-    else {
-        // curate moves if in check
-        if (positionsBlockingCheck) {
-            vector<Move> movesBlockingCheck;
-            for (auto move : moves) {
-                if (positionsBlockingCheck->find(move.to) != positionsBlockingCheck->end()) movesBlockingCheck.push_back(move);
-            }
-            moves = movesBlockingCheck;
-        }
 
-        // curate moves if pinned
-        Board boardWithoutPiece = Board(*this, piece);
-        optional<unordered_set<Piece::Position>> positionsKeepingPin = nullopt;
-        positionsKeepingPin = boardWithoutPiece.getPositionsBlockingCheck();
-        if (positionsKeepingPin) {
-            vector<Move> movesKeepingPin;
-            for (auto move : moves) {
-                if (positionsKeepingPin->find(move.to) != positionsKeepingPin->end()) movesKeepingPin.push_back(move);
+    Bitboard targetMask = getCheckTargetMask();
+    Bitboard pieces = pieceBitboards[indexOf(currentTurn)][indexOf(type)];
+    while (pieces) appendLegalMoves(popLeastSignificantSquare(pieces), targetMask, candidates);
+
+    optional<Move> match;
+    for (const Move& move : candidates) {
+        int from = move.getFromSquare();
+        if (move.getToSquare() != to) continue;
+        if (move.getFlag() == Move::kingsideCastle || move.getFlag() == Move::queensideCastle) continue;
+        if ((fromFile >= 0 && from % 8 != fromFile) || (fromRank >= 0 && from / 8 != fromRank)) continue;
+        if (move.getPromotionType() != promotionType) continue;
+        if (match) return nullopt;
+        match = move;
+    }
+    return match;
+}
+
+std::string Board::toSAN(const Move& move) const {
+    std::string san;
+    int from = move.getFromSquare();
+    int to = move.getToSquare();
+    Piece::Type type = static_cast<Piece::Type>(mailbox[from] % 6);
+
+    if (move.getFlag() == Move::kingsideCastle) san = "O-O";
+    else if (move.getFlag() == Move::queensideCastle) san = "O-O-O";
+    else {
+        if (type != Piece::Type::pawn) {
+            san += Piece::getNotation(type);
+
+            // name the file if that tells the piece apart from the others that could go to the same square, else the
+            // rank, else both
+            thread_local vector<Move> availableMoves;
+            getAvailableMoves(availableMoves);
+            bool ambiguous = false, sameFile = false, sameRank = false;
+            for (const Move& other : availableMoves) {
+                int otherFrom = other.getFromSquare();
+                if (other.getToSquare() != to || otherFrom == from || mailbox[otherFrom] != mailbox[from]) continue;
+                ambiguous = true;
+                sameFile |= otherFrom % 8 == from % 8;
+                sameRank |= otherFrom / 8 == from / 8;
             }
-            moves = movesKeepingPin;
+            if (ambiguous && (!sameFile || sameRank)) san += char('a' + from % 8);
+            if (ambiguous && sameFile) san += char('1' + from / 8);
         }
+        else if (move.isCapture()) san += char('a' + from % 8);
 
-        return moves;
+        if (move.isCapture()) san += 'x';
+        san += { char('a' + to % 8), char('1' + to / 8) };
+        if (auto promotionType = move.getPromotionType()) san += { '=', Piece::getNotation(*promotionType) };
     }
+
+    Board next = *this;
+    next.makeMove(move);
+    if (next.checkers) san += next.getAvailableMoves().empty() ? '#' : '+';
+    return san;
 }
 
-Board::Board() {
-    setDefaultGame();
+int Board::getHalfmoveClock() const {
+    return halfmoveClock;
 }
 
-Board::Board(const Board& board) {
-    for (Piece* piece : board.pieces) {
-        if (piece) pieces.push_back(piece->newCopy());
-        else pieces.push_back(nullptr);
-    }  
+int Board::getFullmoveNumber() const {
+    return fullmoveNumber;
+}
 
-    pieceTypeToCapture = board.pieceTypeToCapture;
+std::uint64_t Board::getHashKey() const {
+    return hashKey;
+}
 
-    turnOrder = board.turnOrder;
+Bitboard Board::getPieceBitboard(const Piece::Color& color, const Piece::Type& type) const {
+    return pieceBitboards[indexOf(color)][indexOf(type)];
+}
 
-    ptrdiff_t turnCount = std::distance(board.turnOrder.begin(), board.currentTurn);
-    currentTurn = std::next(turnOrder.begin(), turnCount);
+Bitboard Board::getColorBitboard(const Piece::Color& color) const {
+    return colorBitboards[indexOf(color)];
+}
 
-    winByCheckmate = board.winByCheckmate;
+// bare kings, a single minor piece, or bishops that all stand on squares of one color
+bool Board::hasInsufficientMaterial() const {
+    const Bitboard LIGHT_SQUARES = 0x55AA55AA55AA55AAULL;
+    const Bitboard* white = pieceBitboards[indexOf(Piece::Color::white)];
+    const Bitboard* black = pieceBitboards[indexOf(Piece::Color::black)];
+    if (white[indexOf(Piece::Type::pawn)] | white[indexOf(Piece::Type::rook)] | white[indexOf(Piece::Type::queen)] |
+        black[indexOf(Piece::Type::pawn)] | black[indexOf(Piece::Type::rook)] | black[indexOf(Piece::Type::queen)]) return false;
 
-    updateAvailableMoves();
+    Bitboard knights = white[indexOf(Piece::Type::knight)] | black[indexOf(Piece::Type::knight)];
+    Bitboard bishops = white[indexOf(Piece::Type::bishop)] | black[indexOf(Piece::Type::bishop)];
+    if (std::popcount(knights | bishops) <= 1) return true;
+    return !knights && (!(bishops & LIGHT_SQUARES) || !(bishops & ~LIGHT_SQUARES));
 }
 
-Board::Board(const Board& board, const Piece* removedPiece) {
-    for (auto piece : board.pieces) {
-        if (piece && piece != removedPiece) pieces.push_back(piece->newCopy());
-        else pieces.push_back(nullptr);
-    }
-
-    pieceTypeToCapture = board.pieceTypeToCapture;
+optional<std::pair<Piece::Color, Piece::Type>> Board::getPieceAt(int square) const {
+    if (mailbox[square] == EMPTY_SQUARE) return nullopt;
+    return std::make_pair(static_cast<Piece::Color>(mailbox[square] / 6), static_cast<Piece::Type>(mailbox[square] % 6));
+}
 
-    turnOrder = board.turnOrder;
+// promotions can push the phase past its maximum, which still counts as a full middlegame
+std::int32_t Board::getPieceSquareScore(const Piece::Color& color) const {
+    std::int32_t midgameScore = midgameScores[indexOf(color)] - midgameScores[indexOf(opponentOf(color))];
+    std::int32_t endgameScore = endgameScores[indexOf(color)] - endgameScores[indexOf(opponentOf(color))];
+    std::int32_t midgamePhase = std::min(phase, std::int32_t(pst::MAX_PHASE));
+    return (midgameScore * midgamePhase + endgameScore * (pst::MAX_PHASE - midgamePhase)) / pst::MAX_PHASE;
+}
 
-    ptrdiff_t turnCount = std::distance(board.turnOrder.begin(), board.currentTurn);
-    currentTurn = std::next(turnOrder.begin(), turnCount);
+vector<Move> Board::getAvailableMoves() const {
+    vector<Move> moves;
+    getAvailableMoves(moves);
+    return moves;
+}
 
-    winByCheckmate = board.winByCheckmate;
+void Board::getAvailableMoves(vector<Move>& moves) const {
+    moves.clear();
+    if (moves.capacity() < MAX_MOVES) moves.reserve(MAX_MOVES);
 
-    updateAvailableMoves();
+    Bitboard targetMask = getCheckTargetMask();
+    Bitboard pieces = colorBitboards[indexOf(currentTurn)];
+    while (pieces) {
+        appendLegalMoves(popLeastSignificantSquare(pieces), targetMask, moves);
+    }
 }
 
-Board::~Board() {
-    for (Piece*& piece : pieces) {
-        delete piece;
+unordered_set<Piece::Position> Board::getPositionsUnderAttack() const {
+    unordered_set<Piece::Position> positionsUnderAttack;
+    Bitboard attacks = getAttackedSquares(opponentOf(currentTurn), colorBitboards[0] | colorBitboards[1]);
+    while (attacks) {
+        positionsUnderAttack.emplace(Piece::Position::fromSquare(popLeastSignificantSquare(attacks)));
     }
+    return positionsUnderAttack;
 }
 
-void Board::setDefaultGame() {
-    turnOrder = {
-        Piece::Color::white,
-        Piece::Color::black
-    };
+bool Board::pieceToCaptureInCheck(const Piece::Color& color) const {
+    if (color == currentTurn) return checkers != 0;
+    Bitboard king = pieceBitboards[indexOf(color)][indexOf(Piece::Type::king)];
+    if (!king) return false;
+    return isSquareAttacked(std::countr_zero(king), opponentOf(color));
+}
 
-    currentTurn = turnOrder.begin();
-
-    pieceTypeToCapture = 'K'; // TODO: unordered_map<Piece::Color, char>
-
-    for (Piece*& piece : pieces) {
-        delete piece;
-    }
-
-    pieces = {
-        new Rook  {Piece::Color::white, Piece::Position{'A', 1}},
-        new Knight{Piece::Color::white, Piece::Position{'B', 1}},
-        new Bishop{Piece::Color::white, Piece::Position{'C', 1}},
-        new Queen {Piece::Color::white, Piece::Position{'D', 1}},
-        new King  {Piece::Color::white, Piece::Position{'E', 1}},
-        new Bishop{Piece::Color::white, Piece::Position{'F', 1}},
-        new Knight{Piece::Color::white, Piece::Position{'G', 1}},
-        new Rook  {Piece::Color::white, Piece::Position{'H', 1}},
-        new Pawn  {Piece::Color::white, Piece::Position{'A', 2}},
-        new Pawn  {Piece::Color::white, Piece::Position{'B', 2}},
-        new Pawn  {Piece::Color::white, Piece::Position{'C', 2}},
-        new Pawn  {Piece::Color::white, Piece::Position{'D', 2}},
-        new Pawn  {Piece::Color::white, Piece::Position{'E', 2}},
-        new Pawn  {Piece::Color::white, Piece::Position{'F', 2}},
-        new Pawn  {Piece::Color::white, Piece::Position{'G', 2}},
-        new Pawn  {Piece::Color::white, Piece::Position{'H', 2}},
-
-        new Pawn  {Piece::Color::black, Piece::Position{'A', 7}},
-        new Pawn  {Piece::Color::black, Piece::Position{'B', 7}},
-        new Pawn  {Piece::Color::black, Piece::Position{'C', 7}},
-        new Pawn  {Piece::Color::black, Piece::Position{'D', 7}},
-        new Pawn  {Piece::Color::black, Piece::Position{'E', 7}},
-        new Pawn  {Piece::Color::black, Piece::Position{'F', 7}},
-        new Pawn  {Piece::Color::black, Piece::Position{'G', 7}},
-        new Pawn  {Piece::Color::black, Piece::Position{'H', 7}},
-        new Rook  {Piece::Color::black, Piece::Position{'A', 8}},
-        new Knight{Piece::Color::black, Piece::Position{'B', 8}},
-        new Bishop{Piece::Color::black, Piece::Position{'C', 8}},
-        new Queen {Piece::Color::black, Piece::Position{'D', 8}},
-        new King  {Piece::Color::black, Piece::Position{'E', 8}},
-        new Bishop{Piece::Color::black, Piece::Position{'F', 8}},
-        new Knight{Piece::Color::black, Piece::Position{'G', 8}},
-        new Rook  {Piece::Color::black, Piece::Position{'H', 8}}
-    };
+void Board::makeMove(const int& moveIndex) {
+    applyMove(getAvailableMoves()[moveIndex]);
+}
 
-    winByCheckmate = true;
+Board::UndoRecord Board::makeMove(const Move& move) {
+    std::uint8_t capturedPiece = move.getFlag() == Move::enPassantCapture ?
+        std::uint8_t(indexOf(opponentOf(currentTurn)) * 6 + indexOf(Piece::Type::pawn)) :
+        mailbox[move.getToSquare()];
+    UndoRecord undoRecord = { capturedPiece, castlingRights, enPassantSquare, hashKey, checkers, pinnedPieces, threatenedSquares, halfmoveClock };
 
-    updateAvailableMoves();
+    applyMove(move);
+    return undoRecord;
 }
 
-vector<tuple<char, Piece::Color, Piece::Position>> Board::getPieces() const {
-    vector<tuple<char, Piece::Color, Piece::Position>> result;
-    for (Piece* piece : pieces) {
-        if (piece) {
-            tuple<char, Piece::Color, Piece::Position> pieceData;
-            pieceData = { piece->getNotation(), piece->color, piece->position };
-            result.push_back(pieceData);
-        }
-    }
-    return result;
-}
+void Board::unmakeMove(const Move& move, const UndoRecord& undoRecord) {
+    int from = move.getFromSquare();
+    int to = move.getToSquare();
 
-Piece::Color Board::getCurrentTurn() const {
-    return *currentTurn;
-}
+    currentTurn = opponentOf(currentTurn);
+    if (currentTurn == Piece::Color::black) --fullmoveNumber;
 
-vector<Move> Board::getAvailableMoves() const {
-    return availableMoves;
-}
+    if (move.getFlag() == Move::kingsideCastle) relocatePiece(from + 1, from + 3);
+    else if (move.getFlag() == Move::queensideCastle) relocatePiece(from - 1, from - 4);
 
-void Board::makeMove(const int& moveIndex) {
-    Move move = availableMoves[moveIndex];
-
-    int f = -1; // from piece index
-    int t = -1; // to piece index
-    for (int i = 0; i < pieces.size(); ++i) {
-        if (pieces[i]) {
-            if (pieces[i]->position == move.from) f = i;
-            if (pieces[i]->position == move.to) t = i;
-        }
+    if (move.isPromotion()) {
+        removePiece(to);
+        placePiece(currentTurn, Piece::Type::pawn, from);
     }
-
-    pieces[f]->position = move.to;
-    if (t != -1) {
-        delete pieces[t];
-        pieces[t] = nullptr;
+    else {
+        relocatePiece(to, from);
     }
-    if (move.effect) move.effect.value()();
 
-    advanceTurn(currentTurn);
-    for (Piece* const& piece : pieces) {
-        if (piece->color == *currentTurn && piece->updateEffect) {
-            piece->updateEffect.value();
-        }
+    if (undoRecord.capturedPiece != EMPTY_SQUARE) {
+        int capturedSquare = move.getFlag() == Move::enPassantCapture ? to + (currentTurn == Piece::Color::white ? -8 : 8) : to;
+        placePiece(static_cast<Piece::Color>(undoRecord.capturedPiece / 6), static_cast<Piece::Type>(undoRecord.capturedPiece % 6), capturedSquare);
     }
 
-    updateAvailableMoves();
-}
\ No newline at end of file
+    castlingRights = undoRecord.castlingRights;
+    enPassantSquare = undoRecord.enPassantSquare;
+    hashKey = undoRecord.hashKey;
+    checkers = undoRecord.checkers;
+    pinnedPieces = undoRecord.pinnedPieces;
+    threatenedSquares = undoRecord.threatenedSquares;
+    halfmoveClock = undoRecord.halfmoveClock;
+}
@@ -5,11 +5,15 @@
 
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_set>
 #include <tuple>
+#include <utility>
 #include <optional>
 #include <functional>
+#include <array>
+#include <cstdint>
 
 
 
@@ -18,14 +22,16 @@ namespace chess::model {
 
     struct Move;
 
+    using Bitboard = std::uint64_t; // one bit per square, A1 = bit 0 through H8 = bit 63
+
     struct Piece
     {
     public:
 
-        virtual Piece* newCopy() const = 0;
-
         enum class Color { white, black };
 
+        enum class Type { pawn, knight, bishop, rook, queen, king };
+
         struct Position
         {
             char x; // file
@@ -38,6 +44,9 @@ namespace chess::model {
             bool operator ==(const Position& p) const;
             bool operator !=(const Position& p) const;
 
+            int toSquare() const;
+            static Position fromSquare(int square);
+
             static bool sameCol(const Position&, const Position&);
             static bool sameRow(const Position&, const Position&);
             static bool sameMainDiagonal(const Position&, const Position&);
@@ -47,127 +56,150 @@ namespace chess::model {
 
         };
 
-        virtual std::vector<std::vector<Move>> getMoves(const Board&) = 0;
-
-        Color color;
-        Position position;
-        std::optional<std::function<void()>> updateEffect = std::nullopt;
-        virtual char getNotation() const = 0;
-
-    protected:
-
-        static std::vector<Piece*> getPieces(const Board&);
-
-        std::vector<std::vector<Move>> generateMovesWithPattern(
-            const std::vector<Position>& pattern,
-            const Board& board);
-        std::vector<std::vector<Move>> generateMovesWithPattern(
-            const std::vector<std::function<Position(Position)>>& pattern,
-            const Board& board);
-    };
-
-    struct Pawn : public Piece
-    {
-        Pawn(Color, Position, bool firstMove = true, bool enPassantCapturable = false);
-        Piece* newCopy() const;
-        std::vector<std::vector<Move>> getMoves(const Board&);
-        char getNotation() const;
-
-        bool firstMove;
-        bool enPassantCapturable;
-    };
-
-    struct Knight : public Piece
-    {
-        Knight(Color, Position);
-        Piece* newCopy() const;
-        std::vector<std::vector<Move>> getMoves(const Board&);
-        char getNotation() const;
-    };
-
-    struct Bishop : public Piece
-    {
-        Bishop(Color, Position);
-        Piece* newCopy() const;
-        std::vector<std::vector<Move>> getMoves(const Board&);
-        char getNotation() const;
+        static char getNotation(Type);
     };
 
-    struct Rook : public Piece
+    // packed into 16 bits: from square in bits 0-5, to square in bits 6-11 and a Flag in bits 12-15
+    struct Move
     {
-        Rook(Color, Position, bool canCastle = true);
-        Piece* newCopy() const;
-        std::vector<std::vector<Move>> getMoves(const Board&);
-        char getNotation() const;
+        enum Flag : std::uint16_t {
+            quiet = 0,
+            doublePawnPush = 1,
+            kingsideCastle = 2,
+            queensideCastle = 3,
+            capture = 4,
+            enPassantCapture = 5,
+            knightPromotion = 8,
+            bishopPromotion = 9,
+            rookPromotion = 10,
+            queenPromotion = 11,
+            knightPromotionCapture = 12,
+            bishopPromotionCapture = 13,
+            rookPromotionCapture = 14,
+            queenPromotionCapture = 15
+        };
 
-        bool canCastle;
-    };
+        Move() = default;
+        Move(int fromSquare, int toSquare, Flag flag = quiet);
+        explicit Move(std::uint16_t encoding);
 
-    struct Queen : public Piece
-    {
-        Queen(Color, Position);
-        Piece* newCopy() const;
-        std::vector<std::vector<Move>> getMoves(const Board&);
-        char getNotation() const;
-    };
+        bool operator ==(const Move& m) const;
+        bool operator !=(const Move& m) const;
 
-    struct King : public Piece
-    {
-        King(Color, Position, bool canCastle = true);
-        Piece* newCopy() const;
-        std::vector<std::vector<Move>> getMoves(const Board&);
-        char getNotation() const;
+        Piece::Position getFrom() const;
+        Piece::Position getTo() const;
+        int getFromSquare() const;
+        int getToSquare() const;
+        Flag getFlag() const;
+        std::uint16_t getEncoding() const;
 
-        bool canCastle;
-    };
+        bool isCapture() const;
+        bool isPromotion() const;
+        std::optional<Piece::Type> getPromotionType() const;
+        std::string getCoordinateNotation() const; // e.g. "e2e4" or "e7e8q"
 
-    struct Move
-    {
-        Move(Piece::Position from, Piece::Position to, std::optional<std::function<void()>> effect = std::nullopt);
+    private:
 
-        Piece::Position from;
-        Piece::Position to;
-        std::optional<std::function<void()>> effect;
+        std::uint16_t encoding;
     };
 
     class Board
     {
     private:
 
-        Board(const Board&, const Piece*);
-
-        std::vector<Piece*> pieces;
-        char pieceTypeToCapture;
-        std::vector<Piece::Color> turnOrder;
-        std::vector<Piece::Color>::const_iterator currentTurn;
-        std::vector<Move> availableMoves;
-        bool winByCheckmate;
-
-        void advanceTurn(std::vector<Piece::Color>::const_iterator&) const;
-        std::optional<Piece::Position> getPieceToCapturePosition(Piece::Color color) const;
-        std::optional<std::unordered_set<Piece::Position>> getPositionsBlockingCheck() const;
-        std::optional<Piece*> getPieceToCapture(Piece::Color) const;
-        std::vector<Move> getValidMoves(Piece*&, const std::optional<std::unordered_set<Piece::Position>>&) const;
-
-        void updateAvailableMoves();
+        static constexpr std::uint8_t EMPTY_SQUARE = 12;
+
+        Bitboard pieceBitboards[2][6]; // indexed by color, then type
+        Bitboard colorBitboards[2];
+        std::array<std::uint8_t, 64> mailbox; // color * 6 + type of the piece on each square, or EMPTY_SQUARE
+        std::uint8_t castlingRights;
+        std::optional<int> enPassantSquare;
+        Piece::Color currentTurn;
+        std::uint16_t halfmoveClock; // plies since the last capture or pawn move
+        std::uint16_t fullmoveNumber; // starts at 1 and goes up after each black move
+        std::uint64_t hashKey;
+        Bitboard checkers; // enemy pieces giving check to the side to move
+        Bitboard pinnedPieces; // side to move's pieces that can only move along the line to their king
+        Bitboard threatenedSquares; // squares the enemy attacks, looking through the side to move's king
+        std::int32_t midgameScores[2]; // material plus piece-square bonus per color, in centipawns
+        std::int32_t endgameScores[2];
+        std::int32_t phase; // see pst::PHASE_WEIGHTS
+
+        void placePiece(Piece::Color, Piece::Type, int square);
+        void removePiece(int square);
+        void relocatePiece(int from, int to);
+        void applyMove(const Move&);
+
+        std::uint64_t getEnPassantKey() const;
+        std::uint64_t computeHashKey() const;
+        void updateCheckInfo();
+
+        Bitboard getAttackedSquares(Piece::Color attacker, Bitboard occupied) const;
+        bool isSquareAttacked(int square, Piece::Color attacker) const;
+        bool isLegalEnPassant(int from) const;
+        Bitboard getCheckTargetMask() const;
+        void appendLegalMoves(int square, Bitboard targetMask, std::vector<Move>&) const;
 
     public:
 
+        // enough to take back a move made with makeMove(const Move&)
+        struct UndoRecord
+        {
+            std::uint8_t capturedPiece;
+            std::uint8_t castlingRights;
+            std::optional<int> enPassantSquare;
+            std::uint64_t hashKey;
+            Bitboard checkers;
+            Bitboard pinnedPieces;
+            Bitboard threatenedSquares;
+            std::uint16_t halfmoveClock;
+        };
+
         Board();
-        Board(const Board&);
-        ~Board();
 
         void setDefaultGame();
+        // Forsyth-Edwards Notation. the two move clocks may be left off, as in EPD, and then read 0 and 1. throws
+        // std::invalid_argument for malformed text or an impossible position, leaving the board as it was. parsing
+        // allocates nothing, so one board can be loaded with position after position at the speed of the text
+        void setFEN(std::string_view fen);
+        static Board fromFEN(std::string_view fen);
+        std::string toFEN() const;
+        // Standard Algebraic Notation as in PGN, such as "Nbd2", "exd6", "e8=Q+" or "O-O". parsing ignores check marks
+        // and annotations, allocates nothing after a thread's first call, and finds no move for an illegal or
+        // ambiguous one
+        std::optional<Move> parseSAN(std::string_view san) const;
+        std::string toSAN(const Move&) const;
 
         std::vector<std::tuple<char, Piece::Color, Piece::Position>> getPieces() const;
         Piece::Color getCurrentTurn() const;
+        int getHalfmoveClock() const;
+        int getFullmoveNumber() const;
+        std::uint64_t getHashKey() const; // Polyglot's Zobrist key, the one standard opening books are indexed by
+        Bitboard getPieceBitboard(const Piece::Color&, const Piece::Type&) const;
+        Bitboard getColorBitboard(const Piece::Color&) const;
+        // pieces of both colors attacking square, with sliders seeing through any square missing from occupied
+        Bitboard getAttackersOf(int square, Bitboard occupied) const;
+        std::optional<std::pair<Piece::Color, Piece::Type>> getPieceAt(int square) const;
+        std::int32_t getPieceSquareScore(const Piece::Color&) const; // material and placement tapered by phase, in centipawns
         std::vector<Move> getAvailableMoves() const;
+        void getAvailableMoves(std::vector<Move>& moves) const; // same moves and order, written into a reusable buffer
         std::unordered_set<Piece::Position>getPositionsUnderAttack() const;
         bool pieceToCaptureInCheck(const Piece::Color&) const;
+        bool hasInsufficientMaterial() const; // neither side can ever mate
 
         void makeMove(const int& selectedMove);
+        UndoRecord makeMove(const Move&);
+        void unmakeMove(const Move&, const UndoRecord&);
 
         friend struct Piece;
 
     };
-}
\ No newline at end of file
+}
+
+template<>
+struct std::hash<chess::model::Piece::Position>
+{
+    size_t operator()(const chess::model::Piece::Position& position) const {
+        return std::hash<int>()(position.toSquare());
+    }
+};
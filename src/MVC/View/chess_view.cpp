@@ -5,12 +5,17 @@
 
 #include "chess_view.h"
 #include "../../MVC/Model/chess_model.h"
+#include "../../Tools/chess_perft.h"
+#include "../../Tools/chess_pgn_reader.h"
+#include "../../Tools/chess_epd_runner.h"
+#include "../../Tools/chess_self_play.h"
 
 #include <iostream>
 #include <vector>
 #include <string>
 #include <tuple>
 #include <optional>
+#include <cmath>
 
 using namespace chess;
 
@@ -37,7 +42,7 @@ namespace chess::view {
 			<< '\n';
 	}
 
-	void printCurrentTurn(const Board& board) {
+	void printCurrentTurn(const model::Board& board) {
 		if (board.getCurrentTurn() == model::Piece::Color::white) {
 			cout << WINDOW_MARGIN << "Current Turn: White (UPPER CASE)" << '\n';
 		}
@@ -50,12 +55,12 @@ namespace chess::view {
 		cout << '\n';
 	}
 
-	string updateBoardString(const Board& board, const optional<model::Piece::Position>& selectedPiece) {
+	string updateBoardString(const model::Board& board, const optional<model::Piece::Position>& selectedPiece) {
 		vector<model::Piece::Position> selectedPieceMoves;
 		if (selectedPiece) {
 			for (auto& availableMove : board.getAvailableMoves()) {
-				if (availableMove.from == *selectedPiece) {
-					selectedPieceMoves.push_back(availableMove.to);
+				if (availableMove.getFrom() == *selectedPiece) {
+					selectedPieceMoves.push_back(availableMove.getTo());
 				}
 			}
 		}
@@ -177,6 +182,9 @@ namespace chess::view {
 			<< WINDOW_MARGIN << "\"reset\"\n"
 			<< WINDOW_MARGIN << "begin a new game without AI\n"
 			<< "\n"
+			<< WINDOW_MARGIN << "\"perft <depth> [--threads] [--fen <fen>] [moves...]\"\n"
+			<< WINDOW_MARGIN << "count move generation leaf nodes from the current position\n"
+			<< "\n"
 			<< WINDOW_MARGIN << "\"exit\"\n"
 			<< WINDOW_MARGIN << "end the game\n"
 			<< "\n"
@@ -187,6 +195,84 @@ namespace chess::view {
 		while (getchar() != '\n');
 	}
 
+	void printPerftResults(const tools::PerftResult& result) {
+		cout << "\n\n\n";
+		for (const auto& [move, nodes] : result.divide) {
+			cout << WINDOW_MARGIN << move.getCoordinateNotation() << ": " << nodes << '\n';
+		}
+
+		double nodesPerSecond = result.seconds > 0 ? result.nodes / result.seconds : 0;
+		cout << '\n'
+			<< WINDOW_MARGIN << "Nodes searched: " << result.nodes << '\n'
+			<< WINDOW_MARGIN << "Time: " << result.seconds << "s\n"
+			<< WINDOW_MARGIN << "Nodes/second: " << std::uint64_t(nodesPerSecond) << "\n\n";
+	}
+
+	void printPgnReport(const tools::PgnReport& report) {
+		cout << "\n\n\n";
+		for (const auto& error : report.errors) {
+			cout << WINDOW_MARGIN << "game " << error.game << ", line " << error.line << ": " << error.reason << " \"" << error.text << "\"\n";
+		}
+
+		double gamesPerSecond = report.seconds > 0 ? report.games / report.seconds : 0;
+		double megabytesPerSecond = report.seconds > 0 ? report.bytes / report.seconds / (1 << 20) : 0;
+		cout << '\n'
+			<< WINDOW_MARGIN << "Games: " << report.games << '\n'
+			<< WINDOW_MARGIN << "Moves: " << report.moves << '\n'
+			<< WINDOW_MARGIN << "Games with errors: " << report.errors.size() << '\n'
+			<< WINDOW_MARGIN << "Time: " << report.seconds << "s\n"
+			<< WINDOW_MARGIN << "Games/second: " << std::uint64_t(gamesPerSecond) << '\n'
+			<< WINDOW_MARGIN << "MB/second: " << megabytesPerSecond << "\n\n";
+	}
+
+	void printEpdReport(const tools::EpdReport& report) {
+		cout << "\n\n\n";
+		for (const auto& error : report.errors) cout << WINDOW_MARGIN << error << '\n';
+		if (!report.errors.empty()) cout << '\n';
+
+		for (const auto& position : report.positions) {
+			cout << WINDOW_MARGIN << position.id << ": " << (position.solved ? "solved " : "failed ") << position.move;
+			if (!position.bestMoves.empty()) {
+				cout << ", bm";
+				for (const auto& move : position.bestMoves) cout << ' ' << move;
+			}
+			if (!position.avoidMoves.empty()) {
+				cout << ", am";
+				for (const auto& move : position.avoidMoves) cout << ' ' << move;
+			}
+			if (position.secondsToSolution) cout << ", found in " << *position.secondsToSolution << "s";
+			cout << ", depth " << position.depth << ", " << position.nodes << " nodes\n";
+		}
+
+		double nodesPerSecond = report.seconds > 0 ? report.nodes / report.seconds : 0;
+		cout << '\n'
+			<< WINDOW_MARGIN << "Solved: " << report.solved << " of " << report.positions.size() << '\n'
+			<< WINDOW_MARGIN << "Nodes searched: " << report.nodes << '\n'
+			<< WINDOW_MARGIN << "Time: " << report.seconds << "s\n"
+			<< WINDOW_MARGIN << "Nodes/second: " << std::uint64_t(nodesPerSecond) << "\n\n";
+	}
+
+	void printSelfPlayGame(const tools::SelfPlayGame& game, const tools::SelfPlayResult& scoreSoFar) {
+		cout << WINDOW_MARGIN << "Game " << game.round << ": " << game.white << " - " << game.black << ' ' << game.result
+			<< " (" << game.termination << "), score +" << scoreSoFar.wins << " -" << scoreSoFar.losses << " =" << scoreSoFar.draws << '\n';
+	}
+
+	// the rating difference is the first engine's over the second's
+	void printSelfPlayResult(const tools::SelfPlayResult& result) {
+		int games = result.wins + result.losses + result.draws;
+		cout << '\n'
+			<< WINDOW_MARGIN << "Games: " << games << '\n'
+			<< WINDOW_MARGIN << "Wins/losses/draws: " << result.wins << '/' << result.losses << '/' << result.draws << '\n'
+			<< WINDOW_MARGIN << "Score: " << (games ? (result.wins + result.draws / 2.0) / games * 100 : 0) << "%\n";
+		if (result.eloDifference) {
+			cout << WINDOW_MARGIN << "Elo difference: " << std::lround(*result.eloDifference) << " +/- " << std::lround(*result.eloMargin) << '\n';
+		}
+		else {
+			cout << WINDOW_MARGIN << "Elo difference: unbounded\n";
+		}
+		cout << WINDOW_MARGIN << "Time: " << result.seconds << "s\n\n";
+	}
+
 	string promptUser() {
 		cout << PROMPT;
 
@@ -5,6 +5,10 @@
 
 
 #include "../../MVC/Model/chess_model.h"
+#include "../../Tools/chess_perft.h"
+#include "../../Tools/chess_pgn_reader.h"
+#include "../../Tools/chess_epd_runner.h"
+#include "../../Tools/chess_self_play.h"
 
 
 
@@ -16,6 +20,11 @@ namespace chess::view {
 	void printBoardString();
 	void printMessage(std::string message);
 	void printHelpMenu();
+	void printPerftResults(const chess::tools::PerftResult& result);
+	void printPgnReport(const chess::tools::PgnReport& report);
+	void printEpdReport(const chess::tools::EpdReport& report);
+	void printSelfPlayGame(const chess::tools::SelfPlayGame& game, const chess::tools::SelfPlayResult& scoreSoFar);
+	void printSelfPlayResult(const chess::tools::SelfPlayResult& result);
 	std::string promptUser();
 
 }
\ No newline at end of file
@@ -0,0 +1,238 @@
+// chess_epd_runner.cpp
+// by Jake Charles Osborne III
+
+
+
+#include "chess_epd_runner.h"
+#include "../MVC/Model/chess_model.h"
+#include "../AI Models/Tree Search Models/Minimax/chess_ai_minimax.h"
+#include "../AI Models/Tree Search Models/Minimax/chess_ai_transposition_table.h"
+#include "../AI Models/chess_ai_time_manager.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <fstream>
+#include <sstream>
+#include <future>
+#include <atomic>
+#include <thread>
+#include <exception>
+#include <chrono>
+#include <algorithm>
+#include <utility>
+#include <stdexcept>
+
+using namespace chess;
+
+using std::string;
+using std::string_view;
+using std::vector;
+using std::optional;
+using std::nullopt;
+
+
+
+namespace {
+
+	const std::size_t TRANSPOSITION_TABLE_MEGABYTES = 16; // per worker, the same as the shared table starts with
+
+	// a position ready to search, with its expected moves resolved against it
+	struct EpdPosition {
+		model::Board board;
+		vector<model::Move> bestMoves;
+		vector<model::Move> avoidMoves;
+		tools::EpdPositionResult result;
+	};
+
+	bool isSolution(const EpdPosition& position, const model::Move& move) {
+		auto contains = [&move](const vector<model::Move>& moves) { return std::find(moves.begin(), moves.end(), move) != moves.end(); };
+		return (position.bestMoves.empty() || contains(position.bestMoves)) && !contains(position.avoidMoves);
+	}
+
+	// four FEN fields, then operations such as 'bm Nf3 Nc3;' or 'id "WAC.001";'. throws std::invalid_argument
+	EpdPosition parseLine(string_view line, int lineNumber) {
+		EpdPosition position;
+		std::size_t fieldEnd = 0;
+		for (int field = 0; field < 4; ++field) {
+			fieldEnd = line.find_first_not_of(' ', fieldEnd);
+			fieldEnd = std::min(line.find(' ', fieldEnd), line.size());
+		}
+		position.board.setFEN(line.substr(0, fieldEnd));
+		if (position.board.getAvailableMoves().empty()) throw std::invalid_argument("no legal moves to search");
+		position.result.id = std::to_string(lineNumber);
+		position.result.fen = position.board.toFEN();
+
+		string_view operations = line.substr(fieldEnd);
+		while (!operations.empty()) {
+			// a semicolon inside a quoted operand does not end the operation
+			std::size_t end = 0;
+			bool quoted = false;
+			for (; end < operations.size() && (quoted || operations[end] != ';'); ++end) {
+				if (operations[end] == '"') quoted = !quoted;
+			}
+			std::istringstream operation{ string(operations.substr(0, end)) };
+			operations.remove_prefix(std::min(end + 1, operations.size()));
+
+			string opcode, operand;
+			if (!(operation >> opcode)) continue;
+			if (opcode == "id") {
+				std::getline(operation >> std::ws, operand);
+				if (operand.size() >= 2 && operand.front() == '"' && operand.back() == '"') operand = operand.substr(1, operand.size() - 2);
+				position.result.id = operand;
+			}
+			else if (opcode == "bm" || opcode == "am") {
+				while (operation >> operand) {
+					auto move = position.board.parseSAN(operand);
+					if (!move) throw std::invalid_argument(opcode + " move " + operand + " is not legal here");
+					(opcode == "bm" ? position.bestMoves : position.avoidMoves).push_back(*move);
+					(opcode == "bm" ? position.result.bestMoves : position.result.avoidMoves).push_back(operand);
+				}
+			}
+		}
+
+		if (position.bestMoves.empty() && position.avoidMoves.empty()) throw std::invalid_argument("no bm or am opcode");
+		return position;
+	}
+
+	// the solution time is when the search last switched to a solution, since an engine that wavers has not found it.
+	// the table is cleared first, so a position's result does not depend on what was searched before it
+	void searchPosition(EpdPosition& position, const ai::SearchLimits& limits, ai::TranspositionTable& transpositionTable) {
+		transpositionTable.clear();
+		tools::EpdPositionResult& result = position.result;
+		result.depth = 0;
+
+		auto onIteration = [&position, &result](const ai::SearchInfo& info) {
+			result.depth = info.depth;
+			if (!isSolution(position, info.principalVariation[0])) {
+				result.secondsToSolution = nullopt;
+				result.nodesToSolution = nullopt;
+			}
+			else if (!result.secondsToSolution) {
+				result.secondsToSolution = std::chrono::duration<double>(info.elapsed).count();
+				result.nodesToSolution = info.nodes;
+			}
+		};
+
+		auto start = std::chrono::steady_clock::now();
+		ai::MinimaxResult searchResult = ai::multithreadingMinimax(position.board, position.board.getCurrentTurn(), limits, 1, transpositionTable, onIteration);
+		result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		result.nodes = searchResult.nodes;
+
+		model::Move move = position.board.getAvailableMoves()[searchResult.moveIndex];
+		result.move = position.board.toSAN(move);
+		result.solved = isSolution(position, move);
+		if (!result.solved) {
+			result.secondsToSolution = nullopt;
+			result.nodesToSolution = nullopt;
+		}
+	}
+
+	string toJson(string_view text) {
+		string json = "\"";
+		for (char c : text) {
+			if (c == '"' || c == '\\') json += '\\';
+			if (static_cast<unsigned char>(c) >= 0x20) json += c;
+		}
+		return json + '"';
+	}
+
+	string toJson(const vector<string>& texts) {
+		string json = "[";
+		for (std::size_t i = 0; i < texts.size(); ++i) json += (i ? ", " : "") + toJson(texts[i]);
+		return json + ']';
+	}
+
+}
+
+namespace chess::tools {
+
+	EpdReport runEpd(const string& filename, const ai::SearchLimits& limits, bool multithreaded) {
+		std::ifstream file(filename);
+		if (!file) throw std::runtime_error(filename + " not available");
+
+		EpdReport report = { {}, {}, 0, 0, 0, 0 };
+		vector<EpdPosition> positions;
+		string line;
+		for (int lineNumber = 1; std::getline(file, line); ++lineNumber) {
+			if (!line.empty() && line.back() == '\r') line.pop_back();
+			if (line.find_first_not_of(" \t") == string::npos || line[0] == '#') continue;
+			try {
+				positions.push_back(parseLine(line, lineNumber));
+			}
+			catch (const std::invalid_argument& error) {
+				report.errors.push_back("line " + std::to_string(lineNumber) + ": " + error.what());
+			}
+		}
+
+		// each worker takes the next position until none are left, searching it with a table of its own
+		std::atomic<std::size_t> nextPosition = 0;
+		auto work = [&positions, &limits, &nextPosition]() {
+			ai::TranspositionTable transpositionTable(TRANSPOSITION_TABLE_MEGABYTES);
+			for (std::size_t i = nextPosition++; i < positions.size(); i = nextPosition++) searchPosition(positions[i], limits, transpositionTable);
+		};
+
+		auto start = std::chrono::steady_clock::now();
+		std::size_t workerCount = multithreaded ? std::max(1u, std::thread::hardware_concurrency()) : 1;
+		if (workerCount == 1) {
+			work();
+		}
+		else {
+			vector<std::future<void>> workers;
+			for (std::size_t i = 0; i < std::min(workerCount, positions.size()); ++i) {
+				workers.push_back(std::async(std::launch::async, [&]() {
+					try {
+						work();
+					}
+					catch (...) {
+						nextPosition = positions.size(); // the other workers stop after their current position
+						throw;
+					}
+				}));
+			}
+			// every worker is joined before the first error is passed on, since they share this frame
+			std::exception_ptr error;
+			for (auto& worker : workers) {
+				try {
+					worker.get();
+				}
+				catch (...) {
+					if (!error) error = std::current_exception();
+				}
+			}
+			if (error) std::rethrow_exception(error);
+		}
+		report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		for (auto& position : positions) {
+			report.solved += position.result.solved;
+			report.nodes += position.result.nodes;
+			report.searchSeconds += position.result.seconds;
+			report.positions.push_back(std::move(position.result));
+		}
+		return report;
+	}
+
+	void writeEpdReport(const EpdReport& report, const string& filename) {
+		std::ofstream file(filename);
+		file << "{\n  \"positions\": [\n";
+		for (std::size_t i = 0; i < report.positions.size(); ++i) {
+			const EpdPositionResult& position = report.positions[i];
+			file << "    { \"id\": " << toJson(position.id) << ", \"fen\": " << toJson(position.fen)
+				<< ", \"bm\": " << toJson(position.bestMoves) << ", \"am\": " << toJson(position.avoidMoves)
+				<< ", \"move\": " << toJson(position.move) << ", \"solved\": " << (position.solved ? "true" : "false")
+				<< ", \"secondsToSolution\": " << (position.secondsToSolution ? std::to_string(*position.secondsToSolution) : "null")
+				<< ", \"nodesToSolution\": " << (position.nodesToSolution ? std::to_string(*position.nodesToSolution) : "null")
+				<< ", \"depth\": " << position.depth << ", \"nodes\": " << position.nodes << ", \"seconds\": " << position.seconds << " }"
+				<< (i + 1 < report.positions.size() ? ",\n" : "\n");
+		}
+		double nodesPerSecond = report.seconds > 0 ? report.nodes / report.seconds : 0;
+		file << "  ],\n  \"errors\": " << toJson(report.errors) << ",\n"
+			<< "  \"total\": " << report.positions.size() << ",\n  \"solved\": " << report.solved << ",\n"
+			<< "  \"nodes\": " << report.nodes << ",\n  \"seconds\": " << report.seconds << ",\n"
+			<< "  \"nodesPerSecond\": " << std::uint64_t(nodesPerSecond) << "\n}\n";
+		if (!file) throw std::runtime_error(filename + " could not be written");
+	}
+
+}
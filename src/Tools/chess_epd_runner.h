@@ -0,0 +1,52 @@
+// chess_epd_runner.h
+// by Jake Charles Osborne III
+#pragma once
+
+
+
+#include "../AI Models/chess_ai_time_manager.h"
+
+#include <string>
+#include <vector>
+#include <optional>
+#include <cstddef>
+#include <cstdint>
+
+
+
+namespace chess::tools {
+
+	struct EpdPositionResult {
+		std::string id; // the position's id opcode, or its line number
+		std::string fen;
+		std::vector<std::string> bestMoves; // bm, in SAN
+		std::vector<std::string> avoidMoves; // am, in SAN
+		std::string move; // the one the search chose, in SAN
+		bool solved;
+		// when the search last settled on a solution it then kept to the end, if it did
+		std::optional<double> secondsToSolution;
+		std::optional<std::uint64_t> nodesToSolution;
+		int depth; // the deepest completed iteration
+		std::uint64_t nodes;
+		double seconds;
+	};
+
+	struct EpdReport {
+		std::vector<EpdPositionResult> positions; // in file order
+		std::vector<std::string> errors; // lines that could not be used, with their line numbers
+		std::size_t solved;
+		std::uint64_t nodes;
+		double searchSeconds; // summed over every position
+		double seconds; // from start to finish, with positions searched side by side
+	};
+
+	// searches every position of an EPD file that has a bm or am opcode, each on one thread under limits with a freshly
+	// cleared transposition table of its own, one at a time per hardware thread. a position is solved when the chosen
+	// move is one of bm and none of am. throws std::runtime_error if the file cannot be read
+	EpdReport runEpd(const std::string& filename, const ai::SearchLimits& limits, bool multithreaded = true);
+
+	// the report as JSON, for scripts comparing one build against another. throws std::runtime_error if the file
+	// cannot be written
+	void writeEpdReport(const EpdReport& report, const std::string& filename);
+
+}
@@ -0,0 +1,90 @@
+// chess_perft.cpp
+// by Jake Charles Osborne III
+
+
+
+#include "chess_perft.h"
+#include "../MVC/Model/chess_model.h"
+#include "../Concurrency/chess_thread_pool.h"
+
+#include <vector>
+#include <future>
+#include <chrono>
+
+using namespace chess;
+
+using std::vector;
+using std::future;
+
+
+
+namespace {
+
+	// walks the tree in place with makeMove and unmakeMove, as the search does, listing each ply's moves into its own
+	// buffer so nothing is allocated once the buffers have grown
+	std::uint64_t countLeafNodes(model::Board& board, int depth, vector<vector<model::Move>>& moveBuffers) {
+		if (depth == 0) return 1;
+
+		vector<model::Move>& availableMoves = moveBuffers[depth];
+		board.getAvailableMoves(availableMoves);
+		if (depth == 1) return availableMoves.size();
+
+		std::uint64_t nodes = 0;
+		for (const model::Move& move : availableMoves) {
+			model::Board::UndoRecord undoRecord = board.makeMove(move);
+			nodes += countLeafNodes(board, depth - 1, moveBuffers);
+			board.unmakeMove(move, undoRecord);
+		}
+		return nodes;
+	}
+
+	std::uint64_t countRootMoveNodes(const model::Board& board, model::Move move, int depth) {
+		model::Board nextBoard = board;
+		nextBoard.makeMove(move);
+		vector<vector<model::Move>> moveBuffers(depth);
+		return countLeafNodes(nextBoard, depth - 1, moveBuffers);
+	}
+
+}
+
+namespace chess::tools {
+
+	PerftResult perft(const model::Board& board, int depth, bool multithreaded) {
+		auto start = std::chrono::steady_clock::now();
+
+		PerftResult result = { {}, 0, 0 };
+		auto availableMoves = board.getAvailableMoves();
+		vector<std::uint64_t> counts(availableMoves.size(), 0);
+
+		if (depth <= 0) {
+			result.nodes = 1;
+		}
+		else if (multithreaded) {
+			concurrency::ThreadPool& threadPool = concurrency::ThreadPool::getInstance();
+			vector<future<std::uint64_t>> futures;
+			for (std::size_t i = 0; i < availableMoves.size(); ++i) {
+				model::Move move = availableMoves[i];
+				futures.push_back(threadPool.submit([&board, move, depth]() { return countRootMoveNodes(board, move, depth); }));
+			}
+			for (std::size_t i = 0; i < availableMoves.size(); ++i) {
+				counts[i] = threadPool.wait(futures[i]);
+			}
+		}
+		else {
+			for (std::size_t i = 0; i < availableMoves.size(); ++i) {
+				counts[i] = countRootMoveNodes(board, availableMoves[i], depth);
+			}
+		}
+
+		if (depth > 0) {
+			for (std::size_t i = 0; i < availableMoves.size(); ++i) {
+				result.divide.push_back({ availableMoves[i], counts[i] });
+				result.nodes += counts[i];
+			}
+		}
+
+		result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		return result;
+	}
+
+}
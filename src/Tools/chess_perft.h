@@ -0,0 +1,25 @@
+// chess_perft.h
+// by Jake Charles Osborne III
+#pragma once
+
+
+
+#include "../MVC/Model/chess_model.h"
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+
+
+namespace chess::tools {
+
+	struct PerftResult {
+		std::vector<std::pair<chess::model::Move, std::uint64_t>> divide; // leaf nodes below each root move
+		std::uint64_t nodes;
+		double seconds;
+	};
+
+	PerftResult perft(const chess::model::Board& board, int depth, bool multithreaded = false);
+
+}
@@ -0,0 +1,248 @@
+// chess_pgn_reader.cpp
+// by Jake Charles Osborne III
+
+
+
+#include "chess_pgn_reader.h"
+#include "../MVC/Model/chess_model.h"
+#include "../IO/chess_mapped_file.h"
+#include "../Concurrency/chess_thread_pool.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <future>
+#include <chrono>
+#include <algorithm>
+#include <utility>
+#include <stdexcept>
+
+using namespace chess;
+
+using std::string_view;
+using std::vector;
+
+
+
+namespace {
+
+	// more chunks than threads, so a thread that drew short games can take another
+	const unsigned CHUNKS_PER_THREAD = 8;
+
+	const string_view WHITESPACE = " \t\r\n";
+	// characters that end a move token without whitespace
+	const string_view TOKEN_DELIMITERS = " \t\r\n{}();[]";
+
+	struct ChunkResult {
+		std::uint64_t games = 0;
+		std::uint64_t moves = 0;
+		std::vector<tools::PgnError> errors; // game counted from 1 within the chunk, line not yet known
+	};
+
+	bool isLineStart(string_view text, std::size_t offset) {
+		return offset == 0 || text[offset - 1] == '\n' || text[offset - 1] == '\r';
+	}
+
+	bool isResult(string_view token) {
+		return token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*";
+	}
+
+	// a game's first tag is a line starting with '[' whose previous non-blank line is not a tag too
+	bool isGameStart(string_view text, std::size_t lineStart) {
+		if (text[lineStart] != '[') return false;
+		std::size_t previousEnd = text.find_last_not_of(WHITESPACE, lineStart == 0 ? 0 : lineStart - 1);
+		if (lineStart == 0 || previousEnd == string_view::npos) return true;
+		std::size_t previousStart = text.find_last_of("\r\n", previousEnd);
+		previousStart = previousStart == string_view::npos ? 0 : previousStart + 1;
+		return text[previousStart] != '[';
+	}
+
+	std::size_t findGameStart(string_view text, std::size_t offset) {
+		while (offset < text.size()) {
+			if (isLineStart(text, offset) && isGameStart(text, offset)) return offset;
+			offset = text.find('\n', offset);
+			if (offset == string_view::npos) break;
+			++offset;
+		}
+		return text.size();
+	}
+
+	// everything from offset up to the closing bracket of the variation that opens there, nested ones and comments included
+	std::size_t skipVariation(string_view text, std::size_t offset, std::size_t end) {
+		int depth = 0;
+		for (; offset < end; ++offset) {
+			if (text[offset] == '(') ++depth;
+			else if (text[offset] == ')' && --depth == 0) return offset + 1;
+			else if (text[offset] == '{') {
+				offset = text.find('}', offset);
+				if (offset == string_view::npos || offset >= end) return end;
+			}
+		}
+		return end;
+	}
+
+	// games whose first tag lies in [begin, end), which always cover whole games
+	ChunkResult readChunk(string_view text, std::size_t begin, std::size_t end, const tools::PgnMoveCallback& onMove) {
+		ChunkResult result;
+		model::Board board;
+		bool gameOpen = false; // tags or moves seen since the last result
+		bool inMovetext = false;
+		bool abandoned = false; // the game hit a move it could not play, so the rest of it is skipped
+
+		auto startGame = [&]() {
+			++result.games;
+			board.setDefaultGame();
+			gameOpen = true;
+			inMovetext = false;
+			abandoned = false;
+		};
+		auto recordError = [&](std::size_t offset, string_view token, const char* reason) {
+			result.errors.push_back({ result.games, 0, offset, std::string(token), reason });
+			abandoned = true;
+		};
+
+		std::size_t offset = begin;
+		while (offset < end) {
+			char c = text[offset];
+			if (WHITESPACE.find(c) != string_view::npos) {
+				++offset;
+				continue;
+			}
+
+			bool lineStart = isLineStart(text, offset);
+			if (c == '[' && lineStart) {
+				if (!gameOpen || inMovetext) startGame();
+				std::size_t lineEnd = std::min(text.find('\n', offset), end);
+
+				std::size_t nameEnd = text.find_first_of(WHITESPACE, offset + 1);
+				std::size_t valueStart = text.find('"', offset);
+				std::size_t valueEnd = string_view::npos;
+				if (valueStart < lineEnd) {
+					valueEnd = valueStart;
+					do valueEnd = text.find('"', valueEnd + 1); while (valueEnd < lineEnd && text[valueEnd - 1] == '\\');
+				}
+				if (valueEnd >= lineEnd || nameEnd > valueStart) {
+					if (!abandoned) recordError(offset, text.substr(offset, lineEnd - offset), "malformed tag");
+				}
+				else if (text.substr(offset + 1, nameEnd - offset - 1) == "FEN") {
+					string_view fen = text.substr(valueStart + 1, valueEnd - valueStart - 1);
+					try {
+						board.setFEN(fen);
+					}
+					catch (const std::invalid_argument& error) {
+						if (!abandoned) recordError(valueStart + 1, fen, error.what());
+					}
+				}
+				offset = lineEnd;
+				continue;
+			}
+			if (c == '{') {
+				std::size_t commentEnd = text.find('}', offset);
+				if (commentEnd == string_view::npos || commentEnd >= end) {
+					if (!abandoned) recordError(offset, "{", "unterminated comment");
+					break;
+				}
+				offset = commentEnd + 1;
+				continue;
+			}
+			if (c == ';' || (c == '%' && lineStart)) {
+				offset = std::min(text.find('\n', offset), end);
+				continue;
+			}
+			if (c == '(') {
+				offset = skipVariation(text, offset, end);
+				continue;
+			}
+
+			std::size_t tokenEnd = std::min(text.find_first_of(TOKEN_DELIMITERS, offset + 1), end);
+			string_view token = text.substr(offset, tokenEnd - offset);
+			std::size_t tokenOffset = offset;
+			offset = tokenEnd;
+
+			if (isResult(token)) {
+				gameOpen = false;
+				continue;
+			}
+			// NAGs, stray brackets and annotations written apart from their move
+			if (token[0] == '$' || token == ")" || token == "}" || token == "]" || token.find_first_not_of("!?") == string_view::npos) continue;
+
+			// move numbers, "12." or "12...", may run straight into the move
+			std::size_t moveStart = token.find_first_not_of("0123456789");
+			if (moveStart != string_view::npos && moveStart > 0 && token[moveStart] == '.') {
+				moveStart = token.find_first_not_of('.', moveStart);
+				tokenOffset += moveStart == string_view::npos ? token.size() : moveStart;
+				token = moveStart == string_view::npos ? string_view() : token.substr(moveStart);
+			}
+			if (token.empty()) continue;
+
+			if (!gameOpen) startGame();
+			inMovetext = true;
+			if (abandoned) continue;
+
+			auto move = board.parseSAN(token);
+			if (!move) {
+				recordError(tokenOffset, token, "illegal or ambiguous move");
+				continue;
+			}
+			if (onMove) onMove(board, *move);
+			board.makeMove(*move);
+			++result.moves;
+		}
+
+		return result;
+	}
+
+}
+
+namespace chess::tools {
+
+	PgnReport readPgn(const std::string& filename, const PgnMoveCallback& onMove, bool multithreaded) {
+		auto start = std::chrono::steady_clock::now();
+
+		io::MappedFile file(filename);
+		string_view text(reinterpret_cast<const char*>(file.getData()), file.getSize());
+
+		concurrency::ThreadPool& threadPool = concurrency::ThreadPool::getInstance();
+		std::size_t chunkCount = multithreaded ? std::size_t(threadPool.getThreadCount()) * CHUNKS_PER_THREAD : 1;
+		vector<std::size_t> boundaries = { 0 };
+		for (std::size_t i = 1; i < chunkCount; ++i) {
+			boundaries.push_back(std::max(boundaries.back(), findGameStart(text, text.size() * i / chunkCount)));
+		}
+		boundaries.push_back(text.size());
+
+		vector<ChunkResult> chunkResults;
+		if (multithreaded) {
+			vector<std::future<ChunkResult>> futures;
+			for (std::size_t i = 0; i + 1 < boundaries.size(); ++i) {
+				if (boundaries[i] == boundaries[i + 1]) continue;
+				futures.push_back(threadPool.submit([text, begin = boundaries[i], end = boundaries[i + 1], &onMove]() {
+					return readChunk(text, begin, end, onMove);
+				}));
+			}
+			for (auto& future : futures) chunkResults.push_back(threadPool.wait(future));
+		}
+		else {
+			chunkResults.push_back(readChunk(text, 0, text.size(), onMove));
+		}
+
+		// chunks count their own games and leave lines to be counted here, once, in file order
+		PgnReport report = { 0, 0, text.size(), 0, {} };
+		std::size_t line = 1;
+		std::size_t lineCountedTo = 0;
+		for (auto& chunkResult : chunkResults) {
+			for (auto& error : chunkResult.errors) {
+				line += std::count(text.begin() + lineCountedTo, text.begin() + error.offset, '\n');
+				lineCountedTo = error.offset;
+				error.game += report.games;
+				error.line = line;
+				report.errors.push_back(std::move(error));
+			}
+			report.games += chunkResult.games;
+			report.moves += chunkResult.moves;
+		}
+
+		report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		return report;
+	}
+
+}
@@ -0,0 +1,44 @@
+// chess_pgn_reader.h
+// by Jake Charles Osborne III
+#pragma once
+
+
+
+#include "../MVC/Model/chess_model.h"
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+
+
+
+namespace chess::tools {
+
+	struct PgnError {
+		std::uint64_t game; // counted from 1 in file order
+		std::size_t line; // counted from 1
+		std::size_t offset; // in bytes from the start of the file
+		std::string text; // as written in the file
+		std::string reason;
+	};
+
+	struct PgnReport {
+		std::uint64_t games;
+		std::uint64_t moves;
+		std::size_t bytes;
+		double seconds;
+		std::vector<PgnError> errors; // in file order, at most one per game
+	};
+
+	// the position before each move of each game; called from several threads at once when reading multithreaded
+	using PgnMoveCallback = std::function<void(const chess::model::Board&, const chess::model::Move&)>;
+
+	// replays every game of a PGN file through the move generator, giving up on a game at its first move that is not
+	// legal. the file is memory-mapped, read in place and split between threads at game boundaries. comments,
+	// variations and NAGs are skipped; a FEN tag sets the starting position. throws std::runtime_error if the file
+	// cannot be mapped
+	PgnReport readPgn(const std::string& filename, const PgnMoveCallback& onMove = nullptr, bool multithreaded = true);
+
+}
@@ -0,0 +1,319 @@
+// chess_self_play.cpp
+// by Jake Charles Osborne III
+
+
+
+#include "chess_self_play.h"
+#include "../MVC/Model/chess_model.h"
+#include "../IO/chess_process.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <memory>
+#include <fstream>
+#include <future>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <ctime>
+#include <cmath>
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+using namespace chess;
+
+using std::string;
+using std::string_view;
+using std::vector;
+using std::optional;
+using std::nullopt;
+using std::chrono::milliseconds;
+
+
+
+namespace {
+
+	const milliseconds HANDSHAKE_TIMEOUT(10000);
+	const milliseconds MOVE_TIMEOUT(60000);
+	const std::size_t PGN_LINE_LENGTH = 80;
+	const double CONFIDENCE_Z = 1.96; // 95%
+
+	// one end of a UCI conversation, kept from game to game
+	class Engine
+	{
+	public:
+
+		// throws std::runtime_error if the engine does not start or answer
+		explicit Engine(const tools::EngineConfig& config) : name(config.name), process(config.commandLine) {
+			process.writeLine("uci");
+			if (!waitFor("uciok")) throw std::runtime_error(name + " did not answer uci");
+			// games are played side by side, one per core, so each engine keeps to one thread
+			process.writeLine("setoption name Threads value 1");
+		}
+
+		~Engine() {
+			try {
+				process.writeLine("quit");
+			}
+			catch (const std::runtime_error&) {}
+		}
+
+		// throws std::runtime_error if the engine is no longer answering
+		void newGame() {
+			process.writeLine("ucinewgame");
+			process.writeLine("isready");
+			if (!waitFor("readyok")) throw std::runtime_error(name + " did not answer isready");
+		}
+
+		// the move in coordinate notation, or nothing if the engine has stopped answering
+		optional<string> getMove(const string& position, const string& goArguments) {
+			try {
+				process.writeLine(position);
+				process.writeLine("go " + goArguments);
+			}
+			catch (const std::runtime_error&) {
+				return nullopt;
+			}
+			while (auto line = process.readLine(MOVE_TIMEOUT)) {
+				if (line->rfind("bestmove ", 0) != 0) continue;
+				std::size_t moveEnd = line->find(' ', 9);
+				return line->substr(9, moveEnd == string::npos ? string::npos : moveEnd - 9);
+			}
+			return nullopt;
+		}
+
+	private:
+
+		string name;
+		io::Process process;
+
+		bool waitFor(string_view reply) {
+			while (auto line = process.readLine(HANDSHAKE_TIMEOUT)) {
+				if (*line == reply) return true;
+			}
+			return false;
+		}
+	};
+
+	struct GameRecord {
+		tools::SelfPlayGame game;
+		string fen; // the opening
+		int fullmoveNumber; // of the opening
+		bool blackToMove; // in the opening
+		vector<string> moves; // in SAN
+		bool forfeited; // an engine stopped answering or played an illegal move, so both are replaced
+	};
+
+	GameRecord playGame(Engine& white, Engine& black, const string& opening, const string& goArguments) {
+		model::Board board = model::Board::fromFEN(opening);
+		GameRecord record = { {}, opening, board.getFullmoveNumber(), board.getCurrentTurn() == model::Piece::Color::black, {}, false };
+		string position = "position fen " + opening;
+		// positions since the last capture or pawn move, the only ones that can come again
+		vector<std::uint64_t> history = { board.getHashKey() };
+		vector<model::Move> moves;
+
+		white.newGame();
+		black.newGame();
+		auto finish = [&record](const char* result, const char* termination) {
+			record.game.result = result;
+			record.game.termination = termination;
+			return record;
+		};
+		while (true) {
+			bool whiteToMove = board.getCurrentTurn() == model::Piece::Color::white;
+			const char* loss = whiteToMove ? "0-1" : "1-0";
+			board.getAvailableMoves(moves);
+			if (moves.empty()) return board.pieceToCaptureInCheck(board.getCurrentTurn()) ? finish(loss, "checkmate") : finish("1/2-1/2", "stalemate");
+			if (board.hasInsufficientMaterial()) return finish("1/2-1/2", "insufficient material");
+			if (board.getHalfmoveClock() >= 100) return finish("1/2-1/2", "fifty-move rule");
+			if (std::count(history.begin(), history.end(), board.getHashKey()) >= 3) return finish("1/2-1/2", "threefold repetition");
+
+			optional<string> reply = (whiteToMove ? white : black).getMove(position, goArguments);
+			if (!reply) {
+				record.forfeited = true;
+				return finish(loss, "time forfeit");
+			}
+			auto move = std::find_if(moves.begin(), moves.end(), [&reply](const model::Move& move) { return move.getCoordinateNotation() == *reply; });
+			if (move == moves.end()) {
+				record.forfeited = true;
+				return finish(loss, "illegal move");
+			}
+
+			record.moves.push_back(board.toSAN(*move));
+			board.makeMove(*move);
+			position += (record.moves.size() == 1 ? " moves " : " ") + *reply;
+			if (board.getHalfmoveClock() == 0) history.clear();
+			history.push_back(board.getHashKey());
+		}
+	}
+
+	// tags in the seven tag roster's order, then the movetext wrapped to PGN's line length
+	void writeGame(std::ofstream& file, const GameRecord& record, const string& date, const string& startingFen) {
+		file << "[Event \"ConsoleChess self-play\"]\n[Site \"?\"]\n[Date \"" << date << "\"]\n"
+			<< "[Round \"" << record.game.round << "\"]\n[White \"" << record.game.white << "\"]\n"
+			<< "[Black \"" << record.game.black << "\"]\n[Result \"" << record.game.result << "\"]\n";
+		if (record.fen != startingFen) file << "[SetUp \"1\"]\n[FEN \"" << record.fen << "\"]\n";
+		file << "[Termination \"" << record.game.termination << "\"]\n\n";
+
+		string line;
+		auto write = [&file, &line](const string& token) {
+			if (!line.empty() && line.size() + 1 + token.size() > PGN_LINE_LENGTH) {
+				file << line << '\n';
+				line.clear();
+			}
+			line += (line.empty() ? "" : " ") + token;
+		};
+		int moveNumber = record.fullmoveNumber;
+		for (std::size_t ply = 0; ply < record.moves.size(); ++ply) {
+			bool blackMove = (ply % 2 == 1) != record.blackToMove;
+			// a move number stays on the line of its move
+			if (!blackMove) write(std::to_string(moveNumber) + ". " + record.moves[ply]);
+			else if (ply == 0) write(std::to_string(moveNumber) + "... " + record.moves[ply]);
+			else write(record.moves[ply]);
+			if (blackMove) ++moveNumber;
+		}
+		write('{' + record.game.termination + '}');
+		write(record.game.result);
+		file << line << "\n\n";
+		file.flush();
+	}
+
+	// the logistic rating difference that expects the given score, from the per-game variance of the scores
+	void updateElo(tools::SelfPlayResult& result) {
+		double games = result.wins + result.losses + result.draws;
+		double score = (result.wins + result.draws / 2.0) / games;
+		if (score <= 0 || score >= 1) {
+			result.eloDifference = nullopt;
+			result.eloMargin = nullopt;
+			return;
+		}
+
+		auto elo = [](double score) { return -400 * std::log10(1 / score - 1); };
+		double variance = (result.wins * std::pow(1 - score, 2) + result.draws * std::pow(0.5 - score, 2) + result.losses * std::pow(score, 2)) / games;
+		double margin = CONFIDENCE_Z * std::sqrt(variance / games);
+		double limit = 0.5 / games; // keeps the interval finite when it reaches a perfect score
+		result.eloDifference = elo(score);
+		result.eloMargin = (elo(std::min(score + margin, 1 - limit)) - elo(std::max(score - margin, limit))) / 2;
+	}
+
+	string today() {
+		std::time_t now = std::time(nullptr);
+		char date[16];
+		std::strftime(date, sizeof(date), "%Y.%m.%d", std::localtime(&now));
+		return date;
+	}
+
+}
+
+namespace chess::tools {
+
+	vector<string> loadOpenings(const string& filename) {
+		std::ifstream file(filename);
+		if (!file) throw std::runtime_error(filename + " not available");
+
+		vector<string> openings;
+		model::Board board;
+		string line;
+		for (int lineNumber = 1; std::getline(file, line); ++lineNumber) {
+			if (!line.empty() && line.back() == '\r') line.pop_back();
+			if (line.find_first_not_of(" \t") == string::npos || line[0] == '#') continue;
+			// a FEN's clocks or an EPD's operations after the first four fields are not needed to start a game
+			std::size_t fieldEnd = 0;
+			for (int field = 0; field < 4; ++field) {
+				fieldEnd = line.find_first_not_of(' ', fieldEnd);
+				fieldEnd = std::min(line.find(' ', fieldEnd), line.size());
+			}
+			try {
+				board.setFEN(string_view(line).substr(0, fieldEnd));
+			}
+			catch (const std::invalid_argument& error) {
+				throw std::runtime_error(filename + " line " + std::to_string(lineNumber) + ": " + error.what());
+			}
+			openings.push_back(board.toFEN());
+		}
+		return openings;
+	}
+
+	// each worker keeps its own pair of engines, replacing them only after a forfeit
+	SelfPlayResult runSelfPlay(const SelfPlayOptions& options, const SelfPlayCallback& onGameEnd) {
+		const string startingFen = model::Board().toFEN();
+		const vector<string> openings = options.openings.empty() ? vector<string>{ startingFen } : options.openings;
+		const string date = today();
+
+		std::ofstream pgnFile;
+		if (!options.pgnFilename.empty()) {
+			pgnFile.open(options.pgnFilename, std::ios::app);
+			if (!pgnFile) throw std::runtime_error(options.pgnFilename + " could not be written");
+		}
+
+		SelfPlayResult result = { 0, 0, 0, 0, nullopt, nullopt };
+		std::mutex resultMutex;
+		std::atomic<int> nextRound = 0;
+		auto start = std::chrono::steady_clock::now();
+
+		auto work = [&]() {
+			std::unique_ptr<Engine> first, second;
+			for (int round = nextRound++; round < options.games; round = nextRound++) {
+				if (!first) first = std::make_unique<Engine>(options.first);
+				if (!second) second = std::make_unique<Engine>(options.second);
+				bool firstIsWhite = round % 2 == 0;
+				const string& opening = openings[(round / 2) % openings.size()];
+				GameRecord record = firstIsWhite
+					? playGame(*first, *second, opening, options.goArguments)
+					: playGame(*second, *first, opening, options.goArguments);
+				record.game.round = round + 1;
+				record.game.white = (firstIsWhite ? options.first : options.second).name;
+				record.game.black = (firstIsWhite ? options.second : options.first).name;
+				if (record.forfeited) {
+					first.reset();
+					second.reset();
+				}
+
+				std::lock_guard<std::mutex> lock(resultMutex);
+				if (record.game.result == "1/2-1/2") ++result.draws;
+				else if ((record.game.result == "1-0") == firstIsWhite) ++result.wins;
+				else ++result.losses;
+				updateElo(result);
+				result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+				if (pgnFile.is_open()) {
+					writeGame(pgnFile, record, date, startingFen);
+					if (!pgnFile) throw std::runtime_error(options.pgnFilename + " could not be written");
+				}
+				if (onGameEnd) onGameEnd(record.game, result);
+			}
+		};
+
+		int concurrency = options.concurrency > 0 ? options.concurrency : int(std::max(1u, std::thread::hardware_concurrency()));
+		vector<std::future<void>> workers;
+		for (int i = 0; i < std::min(concurrency, options.games); ++i) {
+			workers.push_back(std::async(std::launch::async, [&]() {
+				try {
+					work();
+				}
+				catch (...) {
+					nextRound = options.games; // the other workers stop after their current game
+					throw;
+				}
+			}));
+		}
+		// every worker is joined before the first error is passed on, since they share this frame
+		std::exception_ptr error;
+		for (auto& worker : workers) {
+			try {
+				worker.get();
+			}
+			catch (...) {
+				if (!error) error = std::current_exception();
+			}
+		}
+		if (error) std::rethrow_exception(error);
+
+		result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		return result;
+	}
+
+}
@@ -0,0 +1,62 @@
+// chess_self_play.h
+// by Jake Charles Osborne III
+#pragma once
+
+
+
+#include <string>
+#include <vector>
+#include <optional>
+#include <functional>
+
+
+
+namespace chess::tools {
+
+	struct EngineConfig {
+		std::string name; // for the PGN and the report
+		std::vector<std::string> commandLine; // starts a UCI engine, such as this program with "uci" last
+	};
+
+	struct SelfPlayOptions {
+		EngineConfig first;
+		EngineConfig second;
+		int games = 100;
+		int concurrency = 0; // games played at once, one per hardware thread when 0
+		std::string goArguments = "movetime 100"; // sent with every "go"
+		std::vector<std::string> openings; // FENs, each played twice with colors swapped; the usual start when empty
+		std::string pgnFilename; // each finished game is appended here when set
+	};
+
+	struct SelfPlayGame {
+		int round; // counted from 1
+		std::string white;
+		std::string black;
+		std::string result; // as in PGN: "1-0", "0-1" or "1/2-1/2"
+		std::string termination; // such as "checkmate" or "threefold repetition"
+	};
+
+	struct SelfPlayResult {
+		int wins; // from the first engine's point of view
+		int losses;
+		int draws;
+		double seconds;
+		// the first engine's rating over the second's, and the half-width of its 95% confidence interval. nothing while
+		// one engine has scored every point
+		std::optional<double> eloDifference;
+		std::optional<double> eloMargin;
+	};
+
+	// called as each game ends, from whichever thread played it, one call at a time
+	using SelfPlayCallback = std::function<void(const SelfPlayGame&, const SelfPlayResult& scoreSoFar)>;
+
+	// one position per line, as FEN or EPD. throws std::runtime_error for a missing file or a line that is not a position
+	std::vector<std::string> loadOpenings(const std::string& filename);
+
+	// plays the first engine against the second, each game between two freshly prepared UCI processes that are kept
+	// for the next game. games end in checkmate, stalemate, threefold repetition, the fifty-move rule or insufficient
+	// material; an engine that plays an illegal move or says nothing for a minute loses. throws std::runtime_error if
+	// an engine cannot be started or the PGN file cannot be written
+	SelfPlayResult runSelfPlay(const SelfPlayOptions& options, const SelfPlayCallback& onGameEnd = nullptr);
+
+}